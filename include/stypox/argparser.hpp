@@ -2,11 +2,20 @@
 #define _STYPOX_ARGPARSER_HPP_
 
 #include <string>
+#include <string_view>
 #include <array>
 #include <algorithm>
 #include <tuple>
 #include <optional>
 #include <vector>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <cstring>
+#include <charconv>
+#include <bitset>
 
 namespace stypox {
 	template<class... Args>
@@ -14,13 +23,68 @@ namespace stypox {
 		return {list...};
 	}
 
-	template<class T, size_t N>
+	// whether an option can be encountered multiple times while parsing
+	struct SingleUse {
+		static constexpr bool repeatable = false;
+	};
+	struct Repeatable {
+		static constexpr bool repeatable = true;
+	};
+
+	// converts option values to and from binary snapshots, see ArgParser::saveSnapshot()
+	template<class T, class = void>
+	struct Serializer;
+
+	// identifies the type of config struct options declared with pointers to members belong to
+	template<class C>
+	inline constexpr char configTypeTag = 0;
+
+	// appends @param help to @param result, which contains the arguments, aligned at
+	//   @param descriptionIndentation (on the next line if the arguments are longer)
+	inline std::string describe(std::string result, size_t descriptionIndentation, const std::string_view& help, bool required) {
+		if (result.size() <= descriptionIndentation) {
+			result.append(std::string(descriptionIndentation - result.size(), ' '));
+		}
+		else {
+			result += '\n';
+			result.append(std::string(descriptionIndentation, ' '));
+		}
+
+		if (required)
+			result += '*';
+		result.append(help);
+		result += '\n';
+
+		return result;
+	}
+
+	template<class T, size_t N, class UsePolicy = SingleUse>
 	class OptionBase {
+		struct AnyClass {};
+		using MemberPointer = std::array<unsigned char, sizeof(int AnyClass::*)>;
+
 		bool m_alreadySeen;
 		bool m_required;
+		T* m_output; // nullptr if the option is declared with a pointer to member and is not bound yet
+
+		// set if the option is declared with a pointer to a member of a config struct, see bind()
+		const void* m_configType;
+		T* (*m_member)(void* config, const MemberPointer& member);
+		MemberPointer m_memberPointer;
+
+		template<class C>
+		static T* memberOf(void* config, const MemberPointer& member) {
+			T C::* pointer;
+			std::memcpy(&pointer, member.data(), sizeof(pointer));
+			return &(static_cast<C*>(config)->*pointer);
+		}
+
+		// during a transaction values are saved in a copy of the output, made when it is first modified
+		bool m_staging;
+		bool m_seenBeforeStaging;
+		std::optional<T> m_staged;
 	protected:
 		const std::string_view m_name;
-		T& m_output;
 		const std::array<std::string_view, N> m_arguments;
 		const std::string_view m_help;
 
@@ -30,23 +94,88 @@ namespace stypox {
 				const std::string_view& help,
 				bool required) :
 			m_alreadySeen{false}, m_required{required},
-			m_name{name}, m_output{output},
-			m_arguments{arguments}, m_help{help} {}
+			m_output{&output}, m_configType{nullptr}, m_member{nullptr}, m_memberPointer{},
+			m_staging{false}, m_seenBeforeStaging{false}, m_staged{},
+			m_name{name}, m_arguments{arguments}, m_help{help} {}
+		// the output is the member @param output of the config struct passed to bind()
+		template<class C>
+		OptionBase(const std::string_view& name,
+				T C::* output,
+				const std::array<std::string_view, N>& arguments,
+				const std::string_view& help,
+				bool required) :
+			m_alreadySeen{false}, m_required{required},
+			m_output{nullptr}, m_configType{&configTypeTag<C>}, m_member{&memberOf<C>}, m_memberPointer{},
+			m_staging{false}, m_seenBeforeStaging{false}, m_staged{},
+			m_name{name}, m_arguments{arguments}, m_help{help} {
+			static_assert(sizeof(output) == sizeof(MemberPointer), "stypox::OptionBase: unsupported pointer to member");
+			std::memcpy(m_memberPointer.data(), &output, sizeof(output));
+		}
 
-		void updateAlreadySeen(const std::string_view& arg) {
-			if (m_alreadySeen)
-				throw std::runtime_error("Option " + std::string{m_name} + " repeated multiple times: " + std::string{arg});
-			m_alreadySeen = true;
+		const T& boundOutput() const {
+			if (m_output == nullptr)
+				throw std::logic_error("stypox::ArgParser: option " + std::string{m_name} + " is not bound to a config struct");
+			return *m_output;
+		}
+		// @return the output, or its staged copy during a transaction
+		T& output() {
+			// outputs that cannot be copied (e.g. std::unique_ptr) are never staged, see stage()
+			if constexpr(std::is_copy_constructible_v<T>) {
+				if (m_staging) {
+					if (!m_staged.has_value())
+						m_staged.emplace(boundOutput());
+					return *m_staged;
+				}
+			}
+			return const_cast<T&>(boundOutput());
+		}
+		const T& output() const {
+			return m_staged.has_value() ? *m_staged : boundOutput();
+		}
+
+		// @return the argument @param arg starts with, or m_arguments.end()
+		auto findPrefixArgument(const std::string_view& arg) const {
+			return std::find_if(m_arguments.begin(), m_arguments.end(),
+				[&arg](const std::string_view& argument) {
+					if (arg.size() < argument.size())
+						return false;
+					else
+						return arg.substr(0, argument.size()) == argument;
+				});
+		}
+
+		// @return true if the option had not been encountered yet (always, unless the option is Repeatable)
+		bool updateAlreadySeen(const std::string_view& arg) {
+			if constexpr(UsePolicy::repeatable) {
+				return !std::exchange(m_alreadySeen, true);
+			}
+			else {
+				if (m_alreadySeen)
+					throw std::runtime_error("Option " + std::string{m_name} + " repeated multiple times: " + std::string{arg});
+				m_alreadySeen = true;
+				return true;
+			}
+		}
+
+		// "--color" is shown as "--[no-]color" if @param negatable
+		static void appendArgument(std::string& result, const std::string_view& argument, bool negatable) {
+			if (negatable && argument.substr(0, 2) == "--") {
+				result.append("--[no-]");
+				result.append(argument.substr(2));
+			}
+			else {
+				result.append(argument);
+			}
 		}
 
-		std::string usage(const std::string_view& typeName) const {
+		std::string usage(const std::string_view& typeName, bool negatable = false) const {
 			std::string result;
 			if constexpr(N >= 1) {
 				result += ' ';
 				if(!m_required)
 					result += '[';
 
-				result.append(m_arguments[0]);
+				appendArgument(result, m_arguments[0], negatable);
 				result.append(typeName);
 
 				if(!m_required)
@@ -54,41 +183,121 @@ namespace stypox {
 			}
 			return result;
 		}
-		std::string help(size_t descriptionIndentation, const std::string_view& typeName) const {
+		std::string help(size_t descriptionIndentation, const std::string_view& typeName, bool negatable = false) const {
 			std::string result = "  ";
 			for (auto&& argument : m_arguments) {
-				result.append(argument);
+				appendArgument(result, argument, negatable);
 				result.append(typeName);
 				result += ' ';
 			}
-
-			if (result.size() <= descriptionIndentation) {
-				result.append(std::string(descriptionIndentation - result.size(), ' '));
-			}
-			else {
-				result += '\n';
-				result.append(std::string(descriptionIndentation, ' '));
-			}
-
-			if (m_required)
-				result += '*';
-			result.append(m_help);
-			result += '\n';
-
-			return result;
+			return describe(std::move(result), descriptionIndentation);
+		}
+		// appends the description to @param result, which contains the arguments
+		std::string describe(std::string result, size_t descriptionIndentation) const {
+			return stypox::describe(std::move(result), descriptionIndentation, m_help, m_required);
 		}
 	public:
 		// @return true if @param arg is valid
-		virtual bool assign(const std::string_view& arg) = 0;
+		virtual bool assign(const std::string_view& arg) {
+			std::optional<std::string_view> value = match(arg);
+			if (!value.has_value())
+				return false;
+			assignValue(*value, arg);
+			return true;
+		}
+		// @return the value assign(@param arg) would assign (or, for switches, the argument), without
+		//   assigning it, or std::nullopt if @param arg does not match
+		virtual std::optional<std::string_view> match(const std::string_view& arg) const {
+			auto found = findPrefixArgument(arg);
+			if (found == m_arguments.end())
+				return std::nullopt;
+			else if (arg.size() == found->size() && found->back() != '=')
+				return std::nullopt; // e.g. "-o" for the argument "-o": the value is in the next argument
+			return arg.substr(found->size());
+		}
+		// converts and saves @param value, that was provided by @param arg
+		virtual void assignValue(const std::string_view& value, const std::string_view& arg) = 0;
+		// @return true if @param arg is one of the arguments without a value (e.g. "--size" for "--size="),
+		//   so that the value has to be taken from the next argument
+		bool matchesWithoutValue(const std::string_view& arg) const {
+			return std::any_of(m_arguments.begin(), m_arguments.end(),
+				[&arg](const std::string_view& argument) {
+					if (!argument.empty() && argument.back() == '=')
+						return arg == argument.substr(0, argument.size() - 1);
+					else
+						return arg == argument;
+				});
+		}
 		void reset() {
 			m_alreadySeen = false;
 		}
 
+		using OutputType = T;
+
+		// appends the value to @param snapshot, see ArgParser::saveSnapshot()
+		void save(std::string& snapshot) const {
+			Serializer<T>::save(snapshot, output());
+		}
+		// reads the value at the beginning of @param snapshot, removing it, and marks the option as encountered
+		// @return false if @param snapshot does not contain a valid value
+		bool load(std::string_view& snapshot) {
+			if (!Serializer<T>::load(snapshot, output()))
+				return false;
+			m_alreadySeen = true;
+			return true;
+		}
+		// @return the fingerprint of the canonical value, continuing from @param seed, see ArgParser::fingerprint()
+		uint64_t fingerprint(uint64_t seed) const {
+			return Serializer<T>::fingerprint(output(), seed);
+		}
+
+		// makes options declared with a pointer to member write into @param config, whose type is
+		//   identified by @param configType (see configTypeTag); other options are not affected
+		void bind(void* config, const void* configType) {
+			if (m_member == nullptr)
+				return;
+			if (configType != m_configType)
+				throw std::logic_error("stypox::ArgParser::bind(): option " + std::string{m_name} + " is a member of another type");
+			m_output = m_member(config, m_memberPointer);
+		}
+
+		// the next values are saved in a copy of the output, until commit() or rollback()
+		void stage() {
+			static_assert(std::is_copy_constructible_v<T>,
+				"stypox::ArgParser: transactions require options whose outputs can be copied");
+			m_staging = true;
+			m_seenBeforeStaging = m_alreadySeen;
+		}
+		void commit() {
+			if (m_staged.has_value())
+				*m_output = std::move(*m_staged);
+			m_staged.reset();
+			m_staging = false;
+		}
+		void rollback() {
+			m_staged.reset();
+			m_staging = false;
+			m_alreadySeen = m_seenBeforeStaging;
+		}
+
 		void checkValidity() const {
 			if (m_required && !m_alreadySeen)
 				throw std::runtime_error("Option " + std::string{m_name} + " is required");
 		}
 
+		const std::string_view& name() const {
+			return m_name;
+		}
+		bool seen() const {
+			return m_alreadySeen;
+		}
+		bool isRequired() const {
+			return m_required;
+		}
+		const std::array<std::string_view, N>& arguments() const {
+			return m_arguments;
+		}
+
 		virtual std::string usage() const = 0;
 		virtual std::string help(size_t descriptionIndentation) const = 0;
 	};
@@ -131,15 +340,54 @@ namespace stypox {
 			OptionBase<T, N>{name, output, arguments, help, required},
 			m_valueWhenSet{valueWhenSet} {}
 
-		bool assign(const std::string_view& arg) override {
-			if (std::find(this->m_arguments.begin(), this->m_arguments.end(), arg) == this->m_arguments.end()) {
-				return false;
-			}
-			else {
-				this->updateAlreadySeen(arg);
-				this->m_output = m_valueWhenSet;
-				return true;
-			}
+	#if __cplusplus <= 201703L && !defined(__cpp_concepts)
+		template<class C, typename Dummy = T /* useless, but needed for SFINAE */>
+	#else
+		template<class C>
+	#endif
+		SwitchOption(const std::string_view& name,
+					T C::* output,
+					const std::array<std::string_view, N>& arguments,
+					const std::string_view& help,
+					const T& valueWhenSet = true,
+				#if __cplusplus > 201703L || defined(__cpp_concepts)
+					bool required = false)
+						requires std::is_same_v<T, bool> :
+				#else
+					typename std::enable_if_t<std::is_same_v<Dummy, bool>, bool> required = false) :
+				#endif
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_valueWhenSet{valueWhenSet} {}
+
+	#if __cplusplus <= 201703L && !defined(__cpp_concepts)
+		template<class C, typename Dummy = T /* useless, but needed for SFINAE */>
+	#else
+		template<class C>
+	#endif
+		SwitchOption(const std::string_view& name,
+					T C::* output,
+					const std::array<std::string_view, N>& arguments,
+					const std::string_view& help,
+					const T& valueWhenSet,
+				#if __cplusplus > 201703L || defined(__cpp_concepts)
+					bool required = false)
+						requires (!std::is_same_v<T, bool>) :
+				#else
+					typename std::enable_if_t<!std::is_same_v<Dummy, bool>, bool> required = false) :
+				#endif
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_valueWhenSet{valueWhenSet} {}
+
+		static constexpr bool takesValue = false;
+
+		std::optional<std::string_view> match(const std::string_view& arg) const override {
+			if (std::find(this->m_arguments.begin(), this->m_arguments.end(), arg) == this->m_arguments.end())
+				return std::nullopt;
+			return arg;
+		}
+		void assignValue(const std::string_view&, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+			this->output() = m_valueWhenSet;
 		}
 
 		std::string usage() const override {
@@ -150,40 +398,185 @@ namespace stypox {
 		}
 	};
 
+	// a switch that can also be negated, e.g. --no-color for --color
+	template<size_t N, class T = bool>
+	class NegatableSwitchOption : public OptionBase<T, N> {
+		const T m_valueWhenSet;
+		const T m_valueWhenUnset;
+
+		static constexpr std::string_view negationPrefix = "--no-";
+
+		// @return true if @param arg is "--no-" followed by @param argument without "--"
+		static bool isNegation(const std::string_view& arg, const std::string_view& argument) {
+			return argument.size() > 2 && argument.substr(0, 2) == "--" &&
+				arg.size() == argument.size() + negationPrefix.size() - 2 &&
+				arg.substr(0, negationPrefix.size()) == negationPrefix &&
+				arg.substr(negationPrefix.size()) == argument.substr(2);
+		}
+
+	public:
+		void assignSwitch(bool set, const std::string_view& arg) {
+			this->updateAlreadySeen(arg);
+			this->output() = set ? m_valueWhenSet : m_valueWhenUnset;
+		}
+
+	#if __cplusplus <= 201703L && !defined(__cpp_concepts)
+		template<typename Dummy = T /* useless, but needed for SFINAE */>
+	#endif
+		NegatableSwitchOption(const std::string_view& name,
+					T& output,
+					const std::array<std::string_view, N>& arguments,
+					const std::string_view& help,
+					const T& valueWhenSet = true,
+					const T& valueWhenUnset = false,
+				#if __cplusplus > 201703L || defined(__cpp_concepts)
+					bool required = false)
+						requires std::is_same_v<T, bool> :
+				#else
+					typename std::enable_if_t<std::is_same_v<Dummy, bool>, bool> required = false) :
+				#endif
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_valueWhenSet{valueWhenSet}, m_valueWhenUnset{valueWhenUnset} {}
+
+	#if __cplusplus <= 201703L && !defined(__cpp_concepts)
+		template<typename Dummy = T /* useless, but needed for SFINAE */>
+	#endif
+		NegatableSwitchOption(const std::string_view& name,
+					T& output,
+					const std::array<std::string_view, N>& arguments,
+					const std::string_view& help,
+					const T& valueWhenSet,
+					const T& valueWhenUnset,
+				#if __cplusplus > 201703L || defined(__cpp_concepts)
+					bool required = false)
+						requires (!std::is_same_v<T, bool>) :
+				#else
+					typename std::enable_if_t<!std::is_same_v<Dummy, bool>, bool> required = false) :
+				#endif
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_valueWhenSet{valueWhenSet}, m_valueWhenUnset{valueWhenUnset} {}
+
+		static constexpr bool takesValue = false;
+
+		bool assign(const std::string_view& arg) override {
+			// the negated arguments are matched in the same pass, without being stored
+			for (auto&& argument : this->m_arguments) {
+				if (arg == argument) {
+					assignSwitch(true, arg);
+					return true;
+				}
+				else if (isNegation(arg, argument)) {
+					assignSwitch(false, arg);
+					return true;
+				}
+			}
+			return false;
+		}
+		std::optional<std::string_view> match(const std::string_view& arg) const override {
+			if (std::none_of(this->m_arguments.begin(), this->m_arguments.end(),
+					[&arg](const std::string_view& argument) { return arg == argument || isNegation(arg, argument); }))
+				return std::nullopt;
+			return arg;
+		}
+		void assignValue(const std::string_view&, const std::string_view& arg) override {
+			assignSwitch(true, arg);
+		}
+
+		std::string usage() const override {
+			return OptionBase<T, N>::usage("", true);
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<T, N>::help(descriptionIndentation, "", true);
+		}
+	};
+
+	template<class O>
+	constexpr bool isNegatable = false;
+	template<size_t N, class T>
+	constexpr bool isNegatable<NegatableSwitchOption<N, T>> = true;
+
+	// a switch that counts how many times it is encountered, e.g. 3 for -v -v -v or -vvv
+	template<size_t N, class T = int>
+	class CountOption : public OptionBase<T, N, Repeatable> {
+		static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "stypox::CountOption: T must be an integer");
+	public:
+		CountOption(const std::string_view& name,
+				T& output,
+				const std::array<std::string_view, N>& arguments,
+				const std::string_view& help,
+				bool required = false) :
+			OptionBase<T, N, Repeatable>{name, output, arguments, help, required} {}
+
+		static constexpr bool takesValue = false;
+
+		std::optional<std::string_view> match(const std::string_view& arg) const override {
+			if (std::find(this->m_arguments.begin(), this->m_arguments.end(), arg) == this->m_arguments.end())
+				return std::nullopt;
+			return arg;
+		}
+		void assignValue(const std::string_view&, const std::string_view& arg) override {
+			// the first occurrence replaces the default value
+			if (this->updateAlreadySeen(arg))
+				this->output() = 1;
+			else
+				++this->output();
+		}
+		// sets the count to @param count, provided by @param arg, e.g. from an environment variable
+		void assignCount(T count, const std::string_view& arg) {
+			this->updateAlreadySeen(arg);
+			this->output() = count;
+		}
+
+		std::string usage() const override {
+			return OptionBase<T, N, Repeatable>::usage("...");
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<T, N, Repeatable>::help(descriptionIndentation, "...");
+		}
+	};
+
+	template<class O>
+	constexpr bool isCount = false;
+	template<size_t N, class T>
+	constexpr bool isCount<CountOption<N, T>> = true;
+
 	template<class T, size_t N, class F>
 	#if __cplusplus > 201703L || defined(__cpp_concepts)
-		requires requires (T t, const F& f, const std::string_view& s) { t = f(s); }
+		requires requires (T t, const F& f, const std::string_view& s) { t = f(s); } ||
+			requires (T& t, const F& f, const std::string_view& s) { f(t, s); }
 	#endif
 	class ManualOption : public OptionBase<T, N> {
-		const F m_assignerFunctor;
+		// functors taking (T&, string_view) write into the output in place
+		static constexpr bool assignsInPlace = std::is_invocable_v<const F&, T&, const std::string_view&>;
+
+		F m_assignerFunctor;
 	public:
 		ManualOption(const std::string_view& name,
 					T& output,
 					const std::array<std::string_view, N>& arguments,
 					const std::string_view& help,
-					const F& assignerFunctor,
+					F assignerFunctor,
+					bool required = false) :
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_assignerFunctor{std::move(assignerFunctor)} {}
+		template<class C>
+		ManualOption(const std::string_view& name,
+					T C::* output,
+					const std::array<std::string_view, N>& arguments,
+					const std::string_view& help,
+					F assignerFunctor,
 					bool required = false) :
 			OptionBase<T, N>{name, output, arguments, help, required},
-			m_assignerFunctor{assignerFunctor} {}
+			m_assignerFunctor{std::move(assignerFunctor)} {}
 
-		bool assign(const std::string_view& arg) override {
-			if (auto found = std::find_if(
-				this->m_arguments.begin(),
-				this->m_arguments.end(),
-				[&arg](const std::string_view& argument) {
-					if (arg.size() < argument.size())
-						return false;
-					else
-						return arg.substr(0, argument.size()) == argument;
-				});
-				found == this->m_arguments.end()) {
-				return false;
-			}
-			else {
-				this->updateAlreadySeen(arg);
-				this->m_output = m_assignerFunctor(arg.substr(found->size()));
-				return true;
-			}
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+			if constexpr(assignsInPlace)
+				m_assignerFunctor(this->output(), value);
+			else
+				this->output() = m_assignerFunctor(value);
 		}
 
 		std::string usage() const override {
@@ -194,54 +587,308 @@ namespace stypox {
 		}
 	};
 
-	template<class T>
-	T argumentFromString(const std::string_view& argValue, const std::string_view& argName, const std::string_view& originalArg) {
-		if constexpr(std::is_integral_v<T>) {
-			try {
-				char* endOfUsedCharacters;
-				if constexpr(std::is_signed_v<T>) {
-					long long result = std::strtoll(argValue.data(), &endOfUsedCharacters, 10);
-					if (endOfUsedCharacters != argValue.end())
-						throw std::invalid_argument("");
-					if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
-						throw std::out_of_range("");
-					return result;
-				}
-				else {
-					const char* pos = argValue.begin();
-					while (pos != argValue.end() && isspace(*pos)) ++pos;
-					if (pos != argValue.end() && *pos == '-')
-						throw std::out_of_range("");
+	template<class V, size_t M>
+	class ValueTable {
+		static_assert(M >= 1, "stypox::ValueTable: at least one value is required");
 
-					unsigned long long result = std::strtoull(pos, &endOfUsedCharacters, 10);
-					if (endOfUsedCharacters != argValue.end())
-						throw std::invalid_argument("");
-					if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
-						throw std::out_of_range("");
-					return result;
-				}
+		// names are first distributed into buckets, then every bucket gets the
+		// first seed that places all of its names into free slots (hash and displace)
+		static constexpr size_t bucketCount = M;
+		static constexpr size_t slotCount = [] {
+			size_t slots = 1;
+			while (slots < 2 * M)
+				slots *= 2;
+			return slots;
+		}();
+		static constexpr uint32_t maxSeed = 1 << 16;
+
+		std::array<std::pair<std::string_view, V>, M> m_entries;
+		std::array<uint32_t, bucketCount> m_bucketSeeds;
+		std::array<size_t, slotCount> m_slots; // index into m_entries + 1, 0 if free
+
+		static constexpr uint64_t hash(const std::string_view& name, uint64_t seed) {
+			uint64_t result = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+			for (char c : name) {
+				result ^= static_cast<unsigned char>(c);
+				result *= 1099511628211ull;
 			}
-			catch (std::invalid_argument&) {
-				throw std::runtime_error("Option " + std::string{argName} + ": \"" + std::string{argValue} +
-					"\" is not an integer: " + std::string{originalArg});
+			return result ^ (result >> 32);
+		}
+		static constexpr size_t bucketOf(const std::string_view& name) {
+			return hash(name, 0) % bucketCount;
+		}
+		static constexpr size_t slotOf(const std::string_view& name, uint32_t seed) {
+			return hash(name, seed) & (slotCount - 1);
+		}
+
+	public:
+		constexpr ValueTable(const std::array<std::pair<std::string_view, V>, M>& entries) :
+				m_entries{entries}, m_bucketSeeds{}, m_slots{} {
+			for (size_t i = 0; i < M; ++i)
+				for (size_t j = i + 1; j < M; ++j)
+					if (m_entries[i].first == m_entries[j].first)
+						throw std::logic_error("stypox::ValueTable: duplicate value name");
+
+			// group the entries by bucket: members of bucket b are order[bucketStarts[b]..bucketStarts[b+1])
+			std::array<size_t, M> entryBuckets{};
+			std::array<size_t, bucketCount + 1> bucketStarts{};
+			for (size_t i = 0; i < M; ++i) {
+				entryBuckets[i] = bucketOf(m_entries[i].first);
+				++bucketStarts[entryBuckets[i] + 1];
 			}
-			catch (std::out_of_range&) {
-				throw std::runtime_error("Option " + std::string{argName} + ": out of range integer \"" + std::string{argValue} +
-					"\" (must be between " + std::to_string(std::numeric_limits<T>::min()) + " and " +
-					std::to_string(std::numeric_limits<T>::max()) + "): " + std::string{originalArg});
+			for (size_t b = 0; b < bucketCount; ++b)
+				bucketStarts[b + 1] += bucketStarts[b];
+			std::array<size_t, M> order{};
+			std::array<size_t, bucketCount> bucketFill{};
+			for (size_t i = 0; i < M; ++i)
+				order[bucketStarts[entryBuckets[i]] + bucketFill[entryBuckets[i]]++] = i;
+
+			// place bigger buckets first, while most slots are still free
+			std::array<bool, bucketCount> bucketDone{};
+			std::array<size_t, M> attemptSlots{};
+			for (size_t placed = 0; placed < bucketCount; ++placed) {
+				size_t bucket = 0;
+				for (size_t b = 0; b < bucketCount; ++b)
+					if (!bucketDone[b] && (bucketDone[bucket] || bucketFill[b] > bucketFill[bucket]))
+						bucket = b;
+				bucketDone[bucket] = true;
+				if (bucketFill[bucket] == 0)
+					break;
+
+				for (uint32_t seed = 1;; ++seed) {
+					if (seed == maxSeed)
+						throw std::logic_error("stypox::ValueTable: could not build a perfect hash");
+
+					size_t assigned = 0;
+					for (size_t k = bucketStarts[bucket]; k != bucketStarts[bucket + 1]; ++k, ++assigned) {
+						size_t slot = slotOf(m_entries[order[k]].first, seed);
+						if (m_slots[slot] != 0)
+							break;
+						m_slots[slot] = order[k] + 1;
+						attemptSlots[assigned] = slot;
+					}
+
+					if (assigned == bucketFill[bucket]) {
+						m_bucketSeeds[bucket] = seed;
+						break;
+					}
+					for (size_t k = 0; k < assigned; ++k) // undo this attempt
+						m_slots[attemptSlots[k]] = 0;
+				}
 			}
 		}
 
-		else if constexpr(std::is_floating_point_v<T>) {
-			try {
-				char* endOfUsedCharacters;
-				long double result = std::strtold(argValue.data(), &endOfUsedCharacters);
-				if (endOfUsedCharacters != argValue.end())
-					throw std::invalid_argument("");
-				if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
-					throw std::out_of_range("");
-				return result;
-			}
+		// @return the entry named @param name, or nullptr if there is none
+		constexpr const std::pair<std::string_view, V>* find(const std::string_view& name) const {
+			size_t slot = m_slots[slotOf(name, m_bucketSeeds[bucketOf(name)])];
+			if (slot != 0 && m_entries[slot - 1].first == name)
+				return &m_entries[slot - 1];
+			return nullptr;
+		}
+
+		constexpr const std::array<std::pair<std::string_view, V>, M>& entries() const {
+			return m_entries;
+		}
+
+		// @return the names separated by @param separator, in declaration order
+		std::string names(const std::string_view& separator) const {
+			std::string result;
+			for (auto&& entry : m_entries) {
+				if (!result.empty())
+					result.append(separator);
+				result.append(entry.first);
+			}
+			return result;
+		}
+	};
+
+	template<class K, class V, class... Entries>
+	constexpr ValueTable<V, 1 + sizeof...(Entries)> values(const std::pair<K, V>& first, const Entries&... list) {
+		return std::array<std::pair<std::string_view, V>, 1 + sizeof...(Entries)>{
+			std::pair<std::string_view, V>{first.first, first.second},
+			std::pair<std::string_view, V>{list.first, list.second}...};
+	}
+
+	template<class E, size_t N, size_t M>
+	class EnumOption : public OptionBase<E, N> {
+		const ValueTable<E, M> m_values;
+
+		inline std::string typeName() const {
+			return '{' + m_values.names("|") + '}';
+		}
+	public:
+		EnumOption(const std::string_view& name,
+				E& output,
+				const std::array<std::string_view, N>& arguments,
+				const std::string_view& help,
+				const ValueTable<E, M>& values,
+				bool required = false) :
+			OptionBase<E, N>{name, output, arguments, help, required},
+			m_values{values} {}
+
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+			if (auto entry = m_values.find(value); entry != nullptr)
+				this->output() = entry->second;
+			else
+				throw std::runtime_error("Option " + std::string{this->m_name} + ": \"" + std::string{value} +
+					"\" is not one of " + m_values.names(", ") + ": " + std::string{arg});
+		}
+
+		std::string usage() const override {
+			return OptionBase<E, N>::usage(typeName());
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<E, N>::help(descriptionIndentation, typeName());
+		}
+	};
+
+	template<class T, size_t N, class V, size_t M>
+	class FlagsOption : public OptionBase<T, N> {
+		static_assert(!std::is_floating_point_v<T> && !std::is_same_v<T, bool>,
+			"stypox::FlagsOption: T must be an integer or a std::bitset");
+		static_assert(std::is_integral_v<V>, "stypox::FlagsOption: the values in the table must be bit indices");
+
+		const ValueTable<V, M> m_flags;
+
+		static constexpr size_t bitCount() {
+			if constexpr(std::is_integral_v<T>)
+				return std::numeric_limits<std::make_unsigned_t<T>>::digits;
+			else
+				return T{}.size();
+		}
+
+		void setBit(size_t index, bool value) {
+			if constexpr(std::is_integral_v<T>) {
+				using U = std::make_unsigned_t<T>;
+				const U mask = static_cast<U>(U{1} << index);
+				const U bits = static_cast<U>(this->output());
+				this->output() = static_cast<T>(value ? (bits | mask) : (bits & static_cast<U>(~mask)));
+			}
+			else {
+				this->output().set(index, value);
+			}
+		}
+
+		inline std::string typeName() const {
+			return "[+-]{" + m_flags.names("|") + "},...";
+		}
+	public:
+		FlagsOption(const std::string_view& name,
+				T& output,
+				const std::array<std::string_view, N>& arguments,
+				const std::string_view& help,
+				const ValueTable<V, M>& flags,
+				bool required = false) :
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_flags{flags} {
+			for (auto&& flag : m_flags.entries())
+				if (static_cast<std::make_unsigned_t<V>>(flag.second) >= bitCount()) // also catches negative indices
+					throw std::logic_error("stypox::FlagsOption: bit index of flag " + std::string{flag.first} + " out of range");
+		}
+
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+
+			// tokens are views into arg: "name" and "+name" set a bit, "-name" clears it
+			std::string_view remaining = value;
+			while (!remaining.empty()) {
+				size_t comma = remaining.find(',');
+				std::string_view token = remaining.substr(0, comma);
+				remaining.remove_prefix(comma == std::string_view::npos ? remaining.size() : comma + 1);
+				if (token.empty())
+					continue;
+
+				bool set = token.front() != '-';
+				if (token.front() == '-' || token.front() == '+')
+					token.remove_prefix(1);
+
+				if (auto flag = m_flags.find(token); flag != nullptr)
+					setBit(static_cast<size_t>(flag->second), set);
+				else
+					throw std::runtime_error("Option " + std::string{this->m_name} + ": \"" + std::string{token} +
+						"\" is not one of " + m_flags.names(", ") + ": " + std::string{arg});
+			}
+		}
+
+		std::string usage() const override {
+			return OptionBase<T, N>::usage(typeName());
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<T, N>::help(descriptionIndentation, typeName());
+		}
+	};
+
+	// @return @param value converted with std::from_chars, which reads only [value.begin(), value.end()),
+	//   since values may be views that are not null-terminated (e.g. into a memory mapped config file)
+	template<class R>
+	R integerFromString(const std::string_view& value) {
+		const char* pos = value.begin();
+		while (pos != value.end() && isspace(*pos)) ++pos;
+		if constexpr(std::is_signed_v<R>) {
+			if (pos != value.end() && *pos == '+' && std::next(pos) != value.end() && *std::next(pos) != '-')
+				++pos;
+		}
+		else {
+			if (pos != value.end() && *pos == '-')
+				throw std::out_of_range("");
+			if (pos != value.end() && *pos == '+')
+				++pos;
+		}
+
+		R result;
+		auto [endOfUsedCharacters, error] = std::from_chars(pos, value.end(), result);
+		if (error == std::errc::result_out_of_range)
+			throw std::out_of_range("");
+		if (error != std::errc{} || endOfUsedCharacters != value.end())
+			throw std::invalid_argument("");
+		return result;
+	}
+
+	template<class T>
+	T argumentFromString(const std::string_view& argValue, const std::string_view& argName, const std::string_view& originalArg) {
+		if constexpr(std::is_integral_v<T>) {
+			try {
+				if constexpr(std::is_signed_v<T>) {
+					long long result = integerFromString<long long>(argValue);
+					if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
+						throw std::out_of_range("");
+					return result;
+				}
+				else {
+					unsigned long long result = integerFromString<unsigned long long>(argValue);
+					if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
+						throw std::out_of_range("");
+					return result;
+				}
+			}
+			catch (std::invalid_argument&) {
+				throw std::runtime_error("Option " + std::string{argName} + ": \"" + std::string{argValue} +
+					"\" is not an integer: " + std::string{originalArg});
+			}
+			catch (std::out_of_range&) {
+				throw std::runtime_error("Option " + std::string{argName} + ": out of range integer \"" + std::string{argValue} +
+					"\" (must be between " + std::to_string(std::numeric_limits<T>::min()) + " and " +
+					std::to_string(std::numeric_limits<T>::max()) + "): " + std::string{originalArg});
+			}
+		}
+
+		else if constexpr(std::is_floating_point_v<T>) {
+			try {
+				// strtold() reads until the first invalid character, so it is given a null-terminated copy
+				std::string value{argValue};
+				char* endOfUsedCharacters;
+				long double result = std::strtold(value.c_str(), &endOfUsedCharacters);
+				if (endOfUsedCharacters != value.c_str() + value.size())
+					throw std::invalid_argument("");
+				if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
+					throw std::out_of_range("");
+				return result;
+			}
 			catch (std::invalid_argument&) {
 				throw std::runtime_error("Option " + std::string{argName} + ": \"" + std::string{argValue} +
 					"\" is not a decimal: " + std::string{originalArg});
@@ -253,109 +900,1324 @@ namespace stypox {
 			}
 		}
 
-		else // text
-			return T{argValue};
-	}
+		else if constexpr(std::is_same_v<T, std::string_view>) // borrowed text: a view into the argument, no copy
+			return argValue;
+
+		else { // text
+			static_assert(std::is_constructible_v<T, std::string_view>,
+				"stypox::argumentFromString(): T must be an integer, a decimal or constructible from std::string_view");
+			return T{argValue};
+		}
+	}
+
+	template<class T>
+	constexpr std::string_view argumentTypeName() {
+		if constexpr(std::is_integral_v<T>)            return "I";
+		else if constexpr(std::is_floating_point_v<T>) return "D";
+		else /* T is text */                           return "T";
+	}
+
+	template<class T>
+	std::string valueNotAllowedMessage(const std::string_view& argName, const T& value) {
+		if constexpr(std::is_integral_v<T> || std::is_floating_point_v<T>)
+			return "Option " + std::string{argName} + ": value " + std::to_string(value) + " is not allowed";
+		else if constexpr(std::is_constructible_v<std::string, T>)
+			return "Option " + std::string{argName} + ": value \"" + std::string{value} + "\" is not allowed";
+		else if constexpr(std::is_assignable_v<std::string&, T>)
+			return "Option " + std::string{argName} + ": value \"" + (std::string{} = value) + "\" is not allowed";
+		else
+			return "Option " + std::string{argName} + ": value not allowed";
+	}
+
+	constexpr auto defaultOptionValidityChecker = [](auto){ return true; };
+	template<class T, size_t N, class F = decltype(defaultOptionValidityChecker)>
+	#if __cplusplus > 201703L || defined(__cpp_concepts)
+		requires requires (bool b, const F& f, const T& s) { b = f(s); }
+	#endif
+	class Option : public OptionBase<T, N> {
+		static_assert(std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_constructible_v<T, std::string_view>,
+			"stypox::Option: T must be an integer, a decimal or constructible from std::string_view");
+
+		F m_validityChecker;
+
+		inline std::string_view typeName() const {
+			return argumentTypeName<T>();
+		}
+	public:
+		Option(const std::string_view& name,
+			T& output,
+			const std::array<std::string_view, N>& arguments,
+			const std::string_view& help,
+			bool required = false,
+			F validityChecker = defaultOptionValidityChecker) :
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_validityChecker{std::move(validityChecker)} {}
+		template<class C>
+		Option(const std::string_view& name,
+			T C::* output,
+			const std::array<std::string_view, N>& arguments,
+			const std::string_view& help,
+			bool required = false,
+			F validityChecker = defaultOptionValidityChecker) :
+			OptionBase<T, N>{name, output, arguments, help, required},
+			m_validityChecker{std::move(validityChecker)} {}
+
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+			this->output() = argumentFromString<T>(value, this->m_name, arg);
+		}
+
+		void checkValidity() const {
+			OptionBase<T, N>::checkValidity();
+
+			if (!m_validityChecker(this->output()))
+				throw std::runtime_error(valueNotAllowedMessage(this->m_name, this->output()));
+		}
+
+		std::string usage() const override {
+			return OptionBase<T, N>::usage(typeName());
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<T, N>::help(descriptionIndentation, typeName());
+		}
+	};
+
+	template<class T, size_t N, class F = decltype(defaultOptionValidityChecker)>
+	#if __cplusplus > 201703L || defined(__cpp_concepts)
+		requires requires (bool b, const F& f, const T& s) { b = f(s); }
+	#endif
+	class ListOption : public OptionBase<std::vector<T>, N, Repeatable> {
+		static_assert(std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_constructible_v<T, std::string_view>,
+			"stypox::ListOption: T must be an integer, a decimal or constructible from std::string_view");
+
+		const char m_delimiter;
+		F m_validityChecker;
+
+		inline std::string typeName() const {
+			std::string result{argumentTypeName<T>()};
+			if (m_delimiter == '\0') {
+				result.append("...");
+			}
+			else {
+				result.append("[");
+				result += m_delimiter;
+				result.append(argumentTypeName<T>());
+				result.append("...]");
+			}
+			return result;
+		}
+	public:
+		ListOption(const std::string_view& name,
+			std::vector<T>& output,
+			const std::array<std::string_view, N>& arguments,
+			const std::string_view& help,
+			bool required = false,
+			char delimiter = ',',
+			F validityChecker = defaultOptionValidityChecker) :
+			OptionBase<std::vector<T>, N, Repeatable>{name, output, arguments, help, required},
+			m_delimiter{delimiter}, m_validityChecker{std::move(validityChecker)} {}
+
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			// the first occurrence replaces the default values, the next ones append
+			if (this->updateAlreadySeen(arg))
+				this->output().clear();
+
+			if (m_delimiter == '\0') {
+				this->output().push_back(argumentFromString<T>(value, this->m_name, arg));
+				return;
+			}
+
+			// count first, so that the vector is reallocated at most once, but keep growing
+			//   geometrically, since the option can be repeated many times (e.g. in a config file)
+			size_t size = this->output().size() + 1 + std::count(value.begin(), value.end(), m_delimiter);
+			if (size > this->output().capacity())
+				this->output().reserve(std::max(size, 2 * this->output().capacity()));
+			std::string_view remaining = value;
+			while (true) {
+				size_t delimiter = remaining.find(m_delimiter);
+				this->output().push_back(argumentFromString<T>(remaining.substr(0, delimiter), this->m_name, arg));
+				if (delimiter == std::string_view::npos)
+					break;
+				remaining.remove_prefix(delimiter + 1);
+			}
+		}
+
+		void checkValidity() const {
+			OptionBase<std::vector<T>, N, Repeatable>::checkValidity();
+
+			for (auto&& value : this->output())
+				if (!m_validityChecker(value))
+					throw std::runtime_error(valueNotAllowedMessage(this->m_name, value));
+		}
+
+		std::string usage() const override {
+			return OptionBase<std::vector<T>, N, Repeatable>::usage(typeName());
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<std::vector<T>, N, Repeatable>::help(descriptionIndentation, typeName());
+		}
+	};
+
+	enum class DuplicateKeys {
+		lastWins, // the last value replaces the previous ones
+		error,    // a repeated key is a parsing error
+		collect,  // every value is kept, in the order they were provided
+	};
+
+	// a map with string_view keys stored as a sorted vector, so that lookups
+	// are binary searches over contiguous memory
+	template<class V = std::string_view>
+	class FlatMap {
+		std::vector<std::pair<std::string_view, V>> m_entries;
+
+		static bool keyLess(const std::pair<std::string_view, V>& entry, const std::string_view& key) {
+			return entry.first < key;
+		}
+		static bool lessKey(const std::string_view& key, const std::pair<std::string_view, V>& entry) {
+			return key < entry.first;
+		}
+	public:
+		using value_type = std::pair<std::string_view, V>;
+		using const_iterator = typename std::vector<value_type>::const_iterator;
+
+		const_iterator begin() const { return m_entries.begin(); }
+		const_iterator end() const { return m_entries.end(); }
+		size_t size() const { return m_entries.size(); }
+		bool empty() const { return m_entries.empty(); }
+		void clear() { m_entries.clear(); }
+
+		// @return the first entry with @param key, or end()
+		const_iterator find(const std::string_view& key) const {
+			auto found = std::lower_bound(m_entries.begin(), m_entries.end(), key, keyLess);
+			return (found != m_entries.end() && found->first == key) ? found : m_entries.end();
+		}
+		std::pair<const_iterator, const_iterator> equal_range(const std::string_view& key) const {
+			return {std::lower_bound(m_entries.begin(), m_entries.end(), key, keyLess),
+				std::upper_bound(m_entries.begin(), m_entries.end(), key, lessKey)};
+		}
+		size_t count(const std::string_view& key) const {
+			auto range = equal_range(key);
+			return range.second - range.first;
+		}
+		bool contains(const std::string_view& key) const {
+			return find(key) != m_entries.end();
+		}
+		const V& at(const std::string_view& key) const {
+			if (auto found = find(key); found != m_entries.end())
+				return found->second;
+			throw std::out_of_range("stypox::FlatMap::at(): missing key " + std::string{key});
+		}
+
+		// @return false if @param key was already present and @param duplicateKeys is DuplicateKeys::error
+		bool insert(const std::string_view& key, V value, DuplicateKeys duplicateKeys) {
+			auto position = std::upper_bound(m_entries.begin(), m_entries.end(), key, lessKey);
+			if (duplicateKeys != DuplicateKeys::collect && position != m_entries.begin() && std::prev(position)->first == key) {
+				if (duplicateKeys == DuplicateKeys::error)
+					return false;
+				std::prev(position)->second = std::move(value);
+			}
+			else {
+				m_entries.insert(position, value_type{key, std::move(value)});
+			}
+			return true;
+		}
+	};
+
+	template<class V, size_t N>
+	class MapOption : public OptionBase<FlatMap<V>, N, Repeatable> {
+		static_assert(std::is_integral_v<V> || std::is_floating_point_v<V> || std::is_constructible_v<V, std::string_view>,
+			"stypox::MapOption: V must be an integer, a decimal or constructible from std::string_view");
+
+		const DuplicateKeys m_duplicateKeys;
+
+		inline std::string typeName() const {
+			return "T=" + std::string{argumentTypeName<V>()};
+		}
+	public:
+		MapOption(const std::string_view& name,
+			FlatMap<V>& output,
+			const std::array<std::string_view, N>& arguments,
+			const std::string_view& help,
+			bool required = false,
+			DuplicateKeys duplicateKeys = DuplicateKeys::lastWins) :
+			OptionBase<FlatMap<V>, N, Repeatable>{name, output, arguments, help, required},
+			m_duplicateKeys{duplicateKeys} {}
+
+		static constexpr bool takesValue = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			// the first occurrence replaces the default entries, the next ones are added
+			if (this->updateAlreadySeen(arg))
+				this->output().clear();
+
+			size_t equals = value.find('=');
+			if (equals == 0 || equals == std::string_view::npos)
+				throw std::runtime_error("Option " + std::string{this->m_name} + ": \"" + std::string{value} +
+					"\" is not in the format key=value: " + std::string{arg});
+
+			std::string_view key = value.substr(0, equals);
+			if (!this->output().insert(key, argumentFromString<V>(value.substr(equals + 1), this->m_name, arg), m_duplicateKeys))
+				throw std::runtime_error("Option " + std::string{this->m_name} + ": key \"" + std::string{key} +
+					"\" repeated multiple times: " + std::string{arg});
+		}
+
+		std::string usage() const override {
+			return OptionBase<FlatMap<V>, N, Repeatable>::usage(typeName());
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return OptionBase<FlatMap<V>, N, Repeatable>::help(descriptionIndentation, typeName());
+		}
+	};
+
+	// Levenshtein distance from a pattern of at most 64 characters, computed with
+	// Myers' bit-parallel algorithm in one pass over the other string
+	class LevenshteinPattern {
+		std::array<uint64_t, 256> m_positions; // bit i is set if pattern[i] is the character
+		size_t m_size;
+	public:
+		static constexpr size_t maxSize = 64;
+
+		LevenshteinPattern(const std::string_view& pattern) :
+				m_positions{}, m_size{pattern.size()} {
+			if (pattern.size() > maxSize)
+				throw std::length_error("stypox::LevenshteinPattern: pattern longer than 64 characters");
+			for (size_t i = 0; i < pattern.size(); ++i)
+				m_positions[static_cast<unsigned char>(pattern[i])] |= uint64_t{1} << i;
+		}
+
+		size_t distance(const std::string_view& text) const {
+			if (m_size == 0)
+				return text.size();
+
+			const uint64_t last = uint64_t{1} << (m_size - 1);
+			uint64_t positive = ~uint64_t{0}, negative = 0; // vertical deltas of the current column
+			size_t result = m_size;
+			for (char c : text) {
+				const uint64_t equal = m_positions[static_cast<unsigned char>(c)];
+				const uint64_t xv = equal | negative;
+				const uint64_t xh = (((equal & positive) + positive) ^ positive) | equal;
+				uint64_t horizontalPositive = negative | ~(xh | positive);
+				uint64_t horizontalNegative = positive & xh;
+
+				if (horizontalPositive & last)
+					++result;
+				else if (horizontalNegative & last)
+					--result;
+
+				// the first row grows by one at every character of text
+				horizontalPositive = (horizontalPositive << 1) | 1;
+				horizontalNegative <<= 1;
+				positive = horizontalNegative | ~(xv | horizontalPositive);
+				negative = horizontalPositive & xv;
+			}
+			return result;
+		}
+	};
+
+	// a positional argument, i.e. one not introduced by an option argument
+	template<class T, class F = decltype(defaultOptionValidityChecker)>
+	#if __cplusplus > 201703L || defined(__cpp_concepts)
+		requires requires (bool b, const F& f, const T& s) { b = f(s); }
+	#endif
+	class Positional : public OptionBase<T, 0> {
+		static_assert(std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_constructible_v<T, std::string_view>,
+			"stypox::Positional: T must be an integer, a decimal or constructible from std::string_view");
+
+		F m_validityChecker;
+
+		inline std::string typeName() const {
+			return '<' + std::string{this->m_name} + ':' + std::string{argumentTypeName<T>()} + '>';
+		}
+	public:
+		Positional(const std::string_view& name,
+			T& output,
+			const std::string_view& help,
+			bool required = false,
+			F validityChecker = defaultOptionValidityChecker) :
+			OptionBase<T, 0>{name, output, {}, help, required},
+			m_validityChecker{std::move(validityChecker)} {}
+
+		static constexpr bool takesValue = true;
+		static constexpr bool variadic = false;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			this->updateAlreadySeen(arg);
+			this->output() = argumentFromString<T>(value, this->m_name, arg);
+		}
+
+		void checkValidity() const {
+			OptionBase<T, 0>::checkValidity();
+
+			if (!m_validityChecker(this->output()))
+				throw std::runtime_error(valueNotAllowedMessage(this->m_name, this->output()));
+		}
+
+		std::string usage() const override {
+			return this->isRequired() ? ' ' + typeName() : " [" + typeName() + ']';
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return this->describe("  " + typeName() + ' ', descriptionIndentation);
+		}
+	};
+
+	// any number of positional arguments, e.g. SRC... in `cp SRC... DST`
+	template<class T, class F = decltype(defaultOptionValidityChecker)>
+	#if __cplusplus > 201703L || defined(__cpp_concepts)
+		requires requires (bool b, const F& f, const T& s) { b = f(s); }
+	#endif
+	class PositionalList : public OptionBase<std::vector<T>, 0, Repeatable> {
+		static_assert(std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_constructible_v<T, std::string_view>,
+			"stypox::PositionalList: T must be an integer, a decimal or constructible from std::string_view");
+
+		F m_validityChecker;
+
+		inline std::string typeName() const {
+			return '<' + std::string{this->m_name} + ':' + std::string{argumentTypeName<T>()} + ">...";
+		}
+	public:
+		PositionalList(const std::string_view& name,
+			std::vector<T>& output,
+			const std::string_view& help,
+			bool required = false,
+			F validityChecker = defaultOptionValidityChecker) :
+			OptionBase<std::vector<T>, 0, Repeatable>{name, output, {}, help, required},
+			m_validityChecker{std::move(validityChecker)} {}
+
+		static constexpr bool takesValue = true;
+		static constexpr bool variadic = true;
+
+		void assignValue(const std::string_view& value, const std::string_view& arg) override {
+			// the first value replaces the default values, the next ones append
+			if (this->updateAlreadySeen(arg))
+				this->output().clear();
+			this->output().push_back(argumentFromString<T>(value, this->m_name, arg));
+		}
+
+		void checkValidity() const {
+			OptionBase<std::vector<T>, 0, Repeatable>::checkValidity();
+
+			for (auto&& value : this->output())
+				if (!m_validityChecker(value))
+					throw std::runtime_error(valueNotAllowedMessage(this->m_name, value));
+		}
+
+		std::string usage() const override {
+			return this->isRequired() ? ' ' + typeName() : " [" + typeName() + ']';
+		}
+		std::string help(size_t descriptionIndentation) const override {
+			return this->describe("  " + typeName() + ' ', descriptionIndentation);
+		}
+	};
+
+	template<class O, class = void>
+	constexpr bool isPositional = false;
+	template<class O>
+	constexpr bool isPositional<O, std::void_t<decltype(O::variadic)>> = true;
+	template<class O, class = void>
+	constexpr bool isVariadic = false;
+	template<class O>
+	constexpr bool isVariadic<O, std::void_t<decltype(O::variadic)>> = O::variadic;
+
+	class HelpSection {
+		const std::string_view m_title;
+	public:
+		HelpSection(const std::string_view& title) :
+			m_title{title} {}
+
+		std::string help(size_t) const {
+			return std::string{m_title} + '\n';
+		}
+	};
+
+	// a command with its own options, e.g. `build` in `tool build --release`:
+	// @param function is called with the range of arguments starting at the subcommand name
+	//   only when the subcommand is used, so it is the place to construct the sub-parser
+	template<class F>
+	class Subcommand {
+		const std::string_view m_name;
+		const std::string_view m_help;
+		F m_function;
+	public:
+		Subcommand(const std::string_view& name,
+			const std::string_view& help,
+			F function) :
+			m_name{name}, m_help{help},
+			m_function{std::move(function)} {}
+
+		template<class Iter>
+		void run(const Iter& first, const Iter& last) {
+			m_function(first, last);
+		}
+
+		std::string_view name() const {
+			return m_name;
+		}
+
+		std::string help(size_t descriptionIndentation) const {
+			return describe("  " + std::string{m_name} + ' ', descriptionIndentation, m_help, false);
+		}
+	};
+
+	template<class O>
+	constexpr bool isSubcommand = false;
+	template<class F>
+	constexpr bool isSubcommand<Subcommand<F>> = true;
+
+	// whether @param O is an option, and not a HelpSection nor a Subcommand
+	template<class O>
+	constexpr bool isOption = !std::is_same_v<O, HelpSection> && !isSubcommand<O>;
+
+	// whether @param T contains views into the parsed arguments, which must outlive it
+	template<class T>
+	constexpr bool holdsViews = std::is_same_v<T, std::string_view>;
+	template<class T>
+	constexpr bool holdsViews<std::vector<T>> = holdsViews<T>;
+	template<class V>
+	constexpr bool holdsViews<FlatMap<V>> = true; // the keys are views
+	// whether the output of the option @param O holds views, see holdsViews
+	template<class O, class = void>
+	constexpr bool outputHoldsViews = false;
+	template<class O>
+	constexpr bool outputHoldsViews<O, std::void_t<typename O::OutputType>> = holdsViews<typename O::OutputType>;
+
+	template<class T>
+	constexpr bool isBitset = false;
+	template<size_t N>
+	constexpr bool isBitset<std::bitset<N>> = true;
+
+	// the finalizer of splitmix64, used to fingerprint configurations
+	constexpr uint64_t mixFingerprint(uint64_t hash) {
+		hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+		hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+		return hash ^ (hash >> 31);
+	}
+	// @return the fingerprint of @param data, continuing from @param seed; the bytes are read
+	//   8 at a time in little endian order, so that the result is the same on every machine
+	inline uint64_t fingerprintBytes(const std::string_view& data, uint64_t seed) {
+		uint64_t hash = mixFingerprint(seed ^ (data.size() * 0x9e3779b97f4a7c15ull));
+		for (size_t i = 0; i < data.size(); i += 8) {
+			uint64_t word = 0;
+			for (size_t b = 0; b < 8 && i + b < data.size(); ++b)
+				word |= static_cast<uint64_t>(static_cast<unsigned char>(data[i + b])) << (8 * b);
+			hash = mixFingerprint(hash ^ word);
+		}
+		return hash;
+	}
+
+	// the values are saved with the native byte order, since snapshots are meant to be
+	//   restored on the same machine; specialize Serializer for other types (e.g. the outputs
+	//   of ManualOption) with the same static functions
+	template<class T>
+	struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>>> {
+		static void save(std::string& snapshot, const T& value) {
+			snapshot.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+		// @return false if @param snapshot is too short
+		static bool load(std::string_view& snapshot, T& value) {
+			if (snapshot.size() < sizeof(T))
+				return false;
+			std::memcpy(&value, snapshot.data(), sizeof(T));
+			snapshot.remove_prefix(sizeof(T));
+			return true;
+		}
+		// numbers and bitsets are fingerprinted by value, so that the result is the same on every
+		//   machine; other types need a specialization, since their bytes may depend on the machine
+		//   or contain padding
+		static uint64_t fingerprint(const T& value, uint64_t seed) {
+			if constexpr(std::is_floating_point_v<T>) {
+				// -0 and 0 are equal, and NaNs have many representations
+				if (value != value)
+					return mixFingerprint(seed ^ 0x7ff8000000000000ull);
+				double high = value == 0 ? 0.0 : static_cast<double>(value);
+				double low = static_cast<double>(value - static_cast<T>(high)); // keeps long double precision
+				uint64_t highBits, lowBits;
+				std::memcpy(&highBits, &high, sizeof(double));
+				std::memcpy(&lowBits, &low, sizeof(double));
+				return mixFingerprint(mixFingerprint(seed ^ highBits) ^ (low == 0 ? 0 : lowBits));
+			}
+			else if constexpr(std::is_enum_v<T>) {
+				return mixFingerprint(seed ^ static_cast<uint64_t>(static_cast<std::underlying_type_t<T>>(value)));
+			}
+			else if constexpr(std::is_integral_v<T>) {
+				return mixFingerprint(seed ^ static_cast<uint64_t>(value));
+			}
+			else if constexpr(isBitset<T>) {
+				// 64 bits at a time, from the lowest one
+				uint64_t hash = mixFingerprint(seed ^ value.size());
+				for (size_t i = 0; i < value.size(); i += 64) {
+					uint64_t word = 0;
+					for (size_t b = 0; b < 64 && i + b < value.size(); ++b)
+						word |= static_cast<uint64_t>(value[i + b]) << b;
+					hash = mixFingerprint(hash ^ word);
+				}
+				return hash;
+			}
+			else {
+				static_assert(!std::is_same_v<T, T>,
+					"stypox::Serializer: fingerprinting T requires a Serializer specialization with a fingerprint() function");
+				return seed;
+			}
+		}
+	};
+
+	// texts are saved after their length
+	template<>
+	struct Serializer<std::string_view> {
+		static void save(std::string& snapshot, const std::string_view& value) {
+			Serializer<uint64_t>::save(snapshot, value.size());
+			snapshot.append(value);
+		}
+		// restored views point into @param snapshot
+		static bool load(std::string_view& snapshot, std::string_view& value) {
+			uint64_t size;
+			if (!Serializer<uint64_t>::load(snapshot, size) || snapshot.size() < size)
+				return false;
+			value = snapshot.substr(0, size);
+			snapshot.remove_prefix(size);
+			return true;
+		}
+		static uint64_t fingerprint(const std::string_view& value, uint64_t seed) {
+			return fingerprintBytes(value, seed);
+		}
+	};
+	template<>
+	struct Serializer<std::string> {
+		static void save(std::string& snapshot, const std::string& value) {
+			Serializer<std::string_view>::save(snapshot, value);
+		}
+		static bool load(std::string_view& snapshot, std::string& value) {
+			std::string_view view;
+			if (!Serializer<std::string_view>::load(snapshot, view))
+				return false;
+			value = view;
+			return true;
+		}
+		static uint64_t fingerprint(const std::string& value, uint64_t seed) {
+			return fingerprintBytes(value, seed);
+		}
+	};
+
+	// containers are saved as the number of elements followed by the elements
+	template<class T>
+	struct Serializer<std::vector<T>> {
+		static void save(std::string& snapshot, const std::vector<T>& value) {
+			Serializer<uint64_t>::save(snapshot, value.size());
+			for (auto&& element : value)
+				Serializer<T>::save(snapshot, element);
+		}
+		static bool load(std::string_view& snapshot, std::vector<T>& value) {
+			uint64_t size;
+			if (!Serializer<uint64_t>::load(snapshot, size))
+				return false;
+			value.clear();
+			value.reserve(std::min<uint64_t>(size, snapshot.size()));
+			for (uint64_t i = 0; i < size; ++i) {
+				T element;
+				if (!Serializer<T>::load(snapshot, element))
+					return false;
+				value.push_back(std::move(element));
+			}
+			return true;
+		}
+		// the order of the elements matters
+		static uint64_t fingerprint(const std::vector<T>& value, uint64_t seed) {
+			uint64_t hash = mixFingerprint(seed ^ value.size());
+			for (auto&& element : value)
+				hash = Serializer<T>::fingerprint(element, hash);
+			return hash;
+		}
+	};
+	template<class V>
+	struct Serializer<FlatMap<V>> {
+		static void save(std::string& snapshot, const FlatMap<V>& value) {
+			Serializer<uint64_t>::save(snapshot, value.size());
+			for (auto&& [key, element] : value) {
+				Serializer<std::string_view>::save(snapshot, key);
+				Serializer<V>::save(snapshot, element);
+			}
+		}
+		// restored keys point into @param snapshot
+		static bool load(std::string_view& snapshot, FlatMap<V>& value) {
+			uint64_t size;
+			if (!Serializer<uint64_t>::load(snapshot, size))
+				return false;
+			value.clear();
+			for (uint64_t i = 0; i < size; ++i) {
+				std::string_view key;
+				V element;
+				if (!Serializer<std::string_view>::load(snapshot, key) || !Serializer<V>::load(snapshot, element))
+					return false;
+				value.insert(key, std::move(element), DuplicateKeys::collect);
+			}
+			return true;
+		}
+		// the entries are sorted by key, so only the order of the values of the same key matters
+		static uint64_t fingerprint(const FlatMap<V>& value, uint64_t seed) {
+			uint64_t hash = mixFingerprint(seed ^ value.size());
+			for (auto&& [key, element] : value)
+				hash = Serializer<V>::fingerprint(element, fingerprintBytes(key, hash));
+			return hash;
+		}
+	};
+
+	// where the value of an option comes from
+	enum class Source : uint8_t {
+		none, // the option was not encountered: the output was not written (it keeps the default value,
+		      //   or the last one after an option is dropped by ArgParser::parseIncremental())
+		commandLine,
+		environment,
+		configFile,
+		snapshot, // see ArgParser::restoreSnapshot()
+	};
+	struct Provenance {
+		Source source;
+		// the index of the argument in the parsed range (including the executable path, if any),
+		//   of the variable in the environment or the line number in the config file
+		uint32_t position;
+	};
+
+	enum class ParserFlags : unsigned {
+		none = 0,
+		// copy the executable path instead of keeping a view into the parsed range
+		ownExecutableName = 1 << 0,
+		// show only the last component of the executable path in the usage screen
+		executableBasename = 1 << 1,
+		// accept unambiguous prefixes of long arguments, e.g. --ver for --verbose
+		allowAbbreviations = 1 << 2,
+	};
+	constexpr ParserFlags operator|(ParserFlags a, ParserFlags b) {
+		return static_cast<ParserFlags>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+	}
+	constexpr bool operator&(ParserFlags a, ParserFlags b) {
+		return (static_cast<unsigned>(a) & static_cast<unsigned>(b)) != 0;
+	}
+
+	template<class... Options>
+	class ArgParser {
+		std::tuple<Options...> m_options;
+
+		const std::string_view m_programName;
+		// a view into the parsed range, unless the name is stored in m_ownedExecutableName
+		std::optional<std::string_view> m_executableName;
+		std::string m_ownedExecutableName;
+		const size_t m_descriptionIndentation;
+		const ParserFlags m_flags;
+
+		bool m_doneAssigning;
+
+		template<size_t I>
+		using OptionAt = std::tuple_element_t<I, std::tuple<Options...>>;
+
+		// options with a single-character argument (e.g. -x or -o=), indexed by that character
+		struct ShortOption {
+			uint16_t index; // index in m_options + 1, 0 if no option uses the character
+			bool takesValue;
+			bool hasEquals;
+		};
+		static_assert(sizeof...(Options) < std::numeric_limits<uint16_t>::max(), "stypox::ArgParser: too many options");
+		// built the first time a cluster is encountered, so that parsers that never see one don't pay for it
+		std::array<ShortOption, 256> m_shortOptions;
+		bool m_shortOptionsBuilt;
+
+		// long arguments (e.g. --verbose or --size=) without the trailing '=', sorted by name
+		struct LongArgument {
+			std::string_view name;
+			size_t index; // index in m_options
+			bool takesValue;
+		};
+		// built the first time an abbreviation is encountered
+		std::vector<LongArgument> m_longArguments;
+		bool m_longArgumentsBuilt;
+
+		// indices in m_options of the positional arguments, in order
+		static constexpr size_t positionalCount = (size_t{0} + ... + isPositional<Options>);
+		static constexpr std::array<size_t, positionalCount> positionalIndices = [] {
+			constexpr bool positional[] = {isPositional<Options>..., false};
+			std::array<size_t, positionalCount> result{};
+			for (size_t i = 0, j = 0; i < sizeof...(Options); ++i)
+				if (positional[i])
+					result[j++] = i;
+			return result;
+		}();
+		// position in positionalIndices of the PositionalList, or positionalCount if there is none
+		static constexpr size_t variadicPosition = [] {
+			constexpr bool variadic[] = {isVariadic<Options>..., false};
+			size_t result = positionalCount;
+			for (size_t i = 0; i < positionalCount; ++i) {
+				if (variadic[positionalIndices[i]]) {
+					if (result != positionalCount)
+						throw std::logic_error("stypox::ArgParser: at most one PositionalList is allowed");
+					result = i;
+				}
+			}
+			return result;
+		}();
+		// positional arguments before the PositionalList, if any
+		static constexpr size_t fixedPositionalCount = std::min(variadicPosition, positionalCount);
+		// positional arguments after the PositionalList, which can only be assigned once parsing ends
+		static constexpr size_t trailingPositionalCount = variadicPosition == positionalCount ? 0 : positionalCount - variadicPosition - 1;
+
+		static constexpr bool hasSubcommands = (false || ... || isSubcommand<Options>);
+		std::string_view m_subcommand; // the name of the subcommand used in the last parse
+
+		size_t m_positionalArguments; // positional arguments encountered in the current parse
+		struct PendingPositional {
+			std::string_view value;
+			uint32_t position;
+		};
+		std::array<PendingPositional, trailingPositionalCount> m_trailingPositionals; // the last ones, if there is a PositionalList
+
+		// while recording (see parseIncremental()) arguments are matched to options but not assigned
+		struct RawAssignment {
+			size_t index; // index in m_options
+			std::string_view value;
+			std::string_view arg;
+			uint32_t position;
+			bool wholeArgument; // assign(arg) instead of assignValue(value, arg)
+		};
+		bool m_recording;
+		std::vector<RawAssignment> m_rawAssignments;
+		// the raw assignments of every option in the last incremental parse, see rawText()
+		std::array<std::string, sizeof...(Options)> m_rawTexts;
+		bool m_parsedIncrementally;
+
+		Source m_source; // where the arguments being parsed come from
+		uint32_t m_position; // index of the argument being parsed, see Provenance
+		std::array<Provenance, sizeof...(Options)> m_provenance;
+
+		// the argument after an option may be read as its value before moving to it, so the iterator
+		//   must be a forward iterator; every argument is kept alive while it is parsed, so iterators may
+		//   yield temporary strings, unless views into the arguments outlive their iteration, as in
+		//   outputs holding views (e.g. std::string_view) and trailing positional arguments (see m_trailingPositionals)
+		template<class Iter>
+		static constexpr void checkIterator() {
+			// iterators yielding temporaries (e.g. of std::views::transform) have an input iterator category
+			//   even if they are multi-pass, so the C++20 concept is preferred
+		#if defined(__cpp_lib_concepts)
+			constexpr bool isForwardIterator = std::forward_iterator<Iter>;
+		#else
+			constexpr bool isForwardIterator =
+				std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<Iter>::iterator_category>;
+		#endif
+			static_assert(isForwardIterator,
+				"stypox::ArgParser: the arguments must be read with a forward iterator, since the values of options are looked ahead");
+			constexpr bool yieldsReferences = std::is_lvalue_reference_v<decltype(*std::declval<Iter&>())>;
+			static_assert(yieldsReferences || !(false || ... || outputHoldsViews<Options>),
+				"stypox::ArgParser: the iterator must yield references to strings that outlive the parse, "
+				"since some outputs are views into the arguments (e.g. std::string_view or FlatMap keys)");
+			static_assert(yieldsReferences || trailingPositionalCount == 0,
+				"stypox::ArgParser: the iterator must yield references to strings that outlive the parse, "
+				"since a PositionalList followed by positional arguments keeps views into the arguments");
+		}
+
+		template<class Iter>
+		void parseExecutableName(Iter& first, const Iter& last, bool firstArgumentIsExecutablePath) {
+			if (firstArgumentIsExecutablePath) {
+				if (first == last)
+					throw std::out_of_range("stypox::ArgParser::parse(): too few items");
+
+				// a view would dangle if the iterator yields temporary strings
+				if (m_flags & ParserFlags::ownExecutableName || !std::is_lvalue_reference_v<decltype(*first)>) {
+					m_ownedExecutableName = std::string_view{*first};
+					m_executableName = m_ownedExecutableName;
+				}
+				else {
+					m_ownedExecutableName.clear();
+					m_executableName = std::string_view{*first};
+				}
+				++first;
+			}
+			else {
+				m_ownedExecutableName.clear();
+				m_executableName = std::nullopt;
+			}
+		}
+
+		std::optional<std::string_view> executableName() const {
+			if (!m_executableName.has_value())
+				return std::nullopt;
+
+			std::string_view name = m_ownedExecutableName.empty() ? *m_executableName : m_ownedExecutableName;
+			if (m_flags & ParserFlags::executableBasename) {
+				if (size_t separator = name.find_last_of("/\\"); separator != std::string_view::npos)
+					name.remove_prefix(separator + 1);
+			}
+			return name;
+		}
+
+		template<size_t I = 0>
+		inline void assign(const std::string_view& arg) {
+			if constexpr(isOption<OptionAt<I>> && !isPositional<OptionAt<I>>)
+				if (!m_doneAssigning) {
+					if (m_recording) {
+						if (auto value = std::get<I>(m_options).match(arg); (m_doneAssigning = value.has_value()))
+							m_rawAssignments.push_back(RawAssignment{I, *value, arg, m_position, true});
+					}
+					else {
+						m_doneAssigning = std::get<I>(m_options).assign(arg);
+					}
+					if (m_doneAssigning)
+						m_provenance[I] = Provenance{m_source, m_position};
+				}
+			if constexpr(I+1 != sizeof...(Options))
+				assign<I+1>(arg);
+		}
+
+		template<size_t I = 0>
+		inline void assignValueAt(size_t index, const std::string_view& value, const std::string_view& arg) {
+			if constexpr(isOption<OptionAt<I>>) {
+				if (index == I) {
+					if (m_recording)
+						m_rawAssignments.push_back(RawAssignment{I, value, arg, m_position, false});
+					else
+						std::get<I>(m_options).assignValue(value, arg);
+					m_provenance[I] = Provenance{m_source, m_position};
+					return;
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				assignValueAt<I+1>(index, value, arg);
+		}
+
+		template<size_t I = 0>
+		inline void buildShortOptions() {
+			if constexpr(isOption<OptionAt<I>>) {
+				for (auto&& argument : std::get<I>(m_options).arguments()) {
+					bool hasEquals = OptionAt<I>::takesValue && argument.size() == 3 && argument[2] == '=';
+					if ((argument.size() == 2 || hasEquals) && argument[0] == '-' && argument[1] != '-') {
+						// the first option using a character wins, as when matching whole arguments
+						ShortOption& shortOption = m_shortOptions[static_cast<unsigned char>(argument[1])];
+						if (shortOption.index == 0)
+							shortOption = ShortOption{static_cast<uint16_t>(I + 1), OptionAt<I>::takesValue, hasEquals};
+					}
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				buildShortOptions<I+1>();
+		}
+
+		template<size_t I = 0>
+		inline std::string_view optionName(size_t index) const {
+			if constexpr(isOption<OptionAt<I>>)
+				if (index == I)
+					return std::get<I>(m_options).name();
+			if constexpr(I+1 != sizeof...(Options))
+				return optionName<I+1>(index);
+			else
+				return {};
+		}
+
+		template<size_t I = 0>
+		inline void buildLongArguments() {
+			if constexpr(isOption<OptionAt<I>>) {
+				for (auto&& argument : std::get<I>(m_options).arguments()) {
+					if (argument.size() > 2 && argument.substr(0, 2) == "--") {
+						std::string_view name = argument.back() == '=' ? argument.substr(0, argument.size() - 1) : argument;
+						m_longArguments.push_back(LongArgument{name, I, OptionAt<I>::takesValue});
+					}
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options)) {
+				buildLongArguments<I+1>();
+			}
+			else {
+				std::stable_sort(m_longArguments.begin(), m_longArguments.end(),
+					[](const LongArgument& a, const LongArgument& b) { return a.name < b.name; });
+			}
+		}
+
+		// assigns an unambiguous abbreviation of a long argument, e.g. --ver or --ver=1 for --verbose=
+		// @return false if @param first is not an abbreviation
+		template<class Iter>
+		bool assignAbbreviation(const std::string_view& arg, Iter& first, const Iter& last) {
+			if (arg.size() < 3 || arg.substr(0, 2) != "--")
+				return false;
+			if (!m_longArgumentsBuilt) {
+				buildLongArguments();
+				m_longArgumentsBuilt = true;
+			}
+
+			size_t equals = arg.find('=');
+			std::string_view prefix = arg.substr(0, equals);
+			if (prefix.size() <= 2)
+				return false; // e.g. "--=5", which would match every long argument
+			// the arguments starting with prefix are contiguous, since the table is sorted
+			auto candidate = std::lower_bound(m_longArguments.begin(), m_longArguments.end(), prefix,
+				[](const LongArgument& argument, const std::string_view& name) { return argument.name < name; });
+			auto candidatesEnd = candidate;
+			bool ambiguous = false;
+			while (candidatesEnd != m_longArguments.end() && candidatesEnd->name.substr(0, prefix.size()) == prefix) {
+				ambiguous = ambiguous || candidatesEnd->index != candidate->index;
+				++candidatesEnd;
+			}
+
+			if (candidate == candidatesEnd) {
+				return false;
+			}
+			else if (ambiguous) {
+				std::string candidates;
+				for (auto it = candidate; it != candidatesEnd; ++it) {
+					if (!candidates.empty())
+						candidates.append(", ");
+					candidates.append(it->name);
+				}
+				throw std::runtime_error("Ambiguous argument: " + std::string{arg} + " (could be " + candidates + ")");
+			}
+			else if (!candidate->takesValue) {
+				if (equals != std::string_view::npos)
+					throw std::runtime_error("Option " + std::string{optionName(candidate->index)} + " does not take a value: " + std::string{arg});
+				assignValueAt(candidate->index, {}, arg);
+			}
+			else if (equals == std::string_view::npos) {
+				assignNextArgument(candidate->index, arg, first, last);
+			}
+			else {
+				assignValueAt(candidate->index, arg.substr(equals + 1), arg);
+			}
+			return true;
+		}
+
+		// @return the index of the option taking a value whose argument is @param arg
+		//   without the value (e.g. "--size" for "--size="), or sizeof...(Options) if there is none
+		template<size_t I = 0>
+		inline size_t findOptionWithoutValue(const std::string_view& arg) const {
+			if constexpr(isOption<OptionAt<I>>) {
+				if constexpr(OptionAt<I>::takesValue) {
+					if (std::get<I>(m_options).matchesWithoutValue(arg))
+						return I;
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				return findOptionWithoutValue<I+1>(arg);
+			else
+				return sizeof...(Options);
+		}
+
+		// assigns to the option at @param index the argument after @param first, moving @param first to it
+		// @param arg is the argument @param first points to
+		template<class Iter>
+		void assignNextArgument(size_t index, const std::string_view& arg, Iter& first, const Iter& last) {
+			if (std::next(first) == last)
+				throw std::runtime_error("Option " + std::string{optionName(index)} + ": missing value: " + std::string{arg});
+			// kept alive while assigning, in case the iterator yields temporary strings
+			auto&& value = *std::next(first);
+			// the option, and not its value, is the provenance
+			assignValueAt(index, std::string_view{value}, arg);
+			++first;
+			++m_position;
+		}
+
+		// assigns a cluster of single-character options, e.g. -xvf, or -xofile where -o takes a value;
+		// if the last option takes a value and the cluster ends there the value is the next argument
+		// @return false if @param first is not a valid cluster
+		template<class Iter>
+		bool assignCluster(const std::string_view& arg, Iter& first, const Iter& last) {
+			if (arg.size() < 3 || arg[0] != '-' || arg[1] == '-')
+				return false;
+			if (!m_shortOptionsBuilt) {
+				buildShortOptions();
+				m_shortOptionsBuilt = true;
+			}
+
+			// check the whole cluster first, so that nothing is assigned if it is invalid
+			for (size_t i = 1; i < arg.size(); ++i) {
+				const ShortOption& shortOption = m_shortOptions[static_cast<unsigned char>(arg[i])];
+				if (shortOption.index == 0)
+					return false;
+				if (shortOption.takesValue)
+					break;
+			}
+
+			for (size_t i = 1; i < arg.size(); ++i) {
+				const ShortOption& shortOption = m_shortOptions[static_cast<unsigned char>(arg[i])];
+				if (shortOption.takesValue) {
+					// the rest of the cluster is the value
+					std::string_view value = arg.substr(i + 1);
+					if (value.empty())
+						assignNextArgument(shortOption.index - 1, arg, first, last);
+					else if (shortOption.hasEquals && value.front() == '=')
+						assignValueAt(shortOption.index - 1, value.substr(1), arg);
+					else
+						assignValueAt(shortOption.index - 1, value, arg);
+					break;
+				}
+				assignValueAt(shortOption.index - 1, {}, arg);
+			}
+			return true;
+		}
+
+		// parses the argument @param arg, which @param first points to, and also the next one if it is the
+		//   value of an option; in that case @param first is moved to the value
+		// @return false if the argument does not match any option
+		template<class Iter>
+		inline bool parseArgument(const std::string_view& arg, Iter& first, const Iter& last) {
+			m_doneAssigning = false;
+			assign(arg);
+			if (m_doneAssigning)
+				return true;
 
-	constexpr auto defaultOptionValidityChecker = [](auto){ return true; };
-	template<class T, size_t N, class F = decltype(defaultOptionValidityChecker)>
-	#if __cplusplus > 201703L || defined(__cpp_concepts)
-		requires requires (bool b, const F& f, const T& s) { b = f(s); }
-	#endif
-	class Option : public OptionBase<T, N> {
-		const F m_validityChecker;
+			if (size_t index = findOptionWithoutValue(arg); index != sizeof...(Options)) {
+				assignNextArgument(index, arg, first, last);
+				return true;
+			}
+			return assignCluster(arg, first, last) ||
+				(m_flags & ParserFlags::allowAbbreviations && assignAbbreviation(arg, first, last));
+		}
 
-		inline std::string_view typeName() const {
-			if constexpr(std::is_integral_v<T>)            return "I";
-			else if constexpr(std::is_floating_point_v<T>) return "D";
-			else /* T is text */                           return "T";
+		void resetPositionals() {
+			m_subcommand = {};
+			m_positionalArguments = 0;
 		}
-	public:
-		Option(const std::string_view& name,
-			T& output,
-			const std::array<std::string_view, N>& arguments,
-			const std::string_view& help,
-			bool required = false,
-			const F& validityChecker = defaultOptionValidityChecker) :
-			OptionBase<T, N>{name, output, arguments, help, required},
-			m_validityChecker{validityChecker} {}
 
-		bool assign(const std::string_view& arg) override {
-			if (auto found = std::find_if(
-				this->m_arguments.begin(),
-				this->m_arguments.end(),
-				[&arg](const std::string_view& argument) {
-					if (arg.size() < argument.size())
-						return false;
-					else
-						return arg.substr(0, argument.size()) == argument;
-				});
-				found == this->m_arguments.end()) {
+		// @return false if there is no positional argument left for @param arg
+		bool assignPositional(const std::string_view& arg) {
+			if constexpr(positionalCount == 0) {
 				return false;
 			}
 			else {
-				this->updateAlreadySeen(arg);
-				this->m_output = argumentFromString<T>(arg.substr(found->size()), this->m_name, arg);
+				size_t position = m_positionalArguments;
+				if (position < variadicPosition || variadicPosition == positionalCount) {
+					if (position == positionalCount)
+						return false;
+					assignValueAt(positionalIndices[position], arg, arg);
+				}
+				else if constexpr(trailingPositionalCount == 0) {
+					assignValueAt(positionalIndices[variadicPosition], arg, arg);
+				}
+				else {
+					// keep the last ones for the trailing positional arguments, the others go to the list
+					size_t trailing = position - variadicPosition;
+					if (trailing >= trailingPositionalCount) {
+						assignPendingPositional(positionalIndices[variadicPosition], m_trailingPositionals[0]);
+						std::move(m_trailingPositionals.begin() + 1, m_trailingPositionals.end(), m_trailingPositionals.begin());
+						trailing = trailingPositionalCount - 1;
+					}
+					m_trailingPositionals[trailing] = PendingPositional{arg, m_position};
+				}
+				++m_positionalArguments;
 				return true;
 			}
 		}
 
-		void checkValidity() const {
-			OptionBase<T, N>::checkValidity();
+		void assignPendingPositional(size_t index, const PendingPositional& pending) {
+			uint32_t position = std::exchange(m_position, pending.position);
+			assignValueAt(index, pending.value, pending.value);
+			m_position = position;
+		}
 
-			if (!m_validityChecker(this->m_output)) {
-				if constexpr(std::is_integral_v<T> || std::is_floating_point_v<T>)
-					throw std::runtime_error("Option " + std::string{this->m_name} + ": value " + std::to_string(this->m_output) + " is not allowed");
-				else if constexpr(std::is_constructible_v<std::string, T>)
-					throw std::runtime_error("Option " + std::string{this->m_name} + ": value \"" + std::string{this->m_output} + "\" is not allowed");
-				else if constexpr(std::is_assignable_v<std::string&, T>)
-					throw std::runtime_error("Option " + std::string{this->m_name} + ": value \"" + (std::string{} = this->m_output) + "\" is not allowed");
-				else
-					throw std::runtime_error("Option " + std::string{this->m_name} + ": value not allowed");
+		// assigns the positional arguments after the PositionalList
+		void finishPositionals() {
+			if constexpr(trailingPositionalCount != 0) {
+				if (m_positionalArguments > variadicPosition) {
+					size_t trailing = std::min(m_positionalArguments - variadicPosition, trailingPositionalCount);
+					for (size_t i = 0; i < trailing; ++i)
+						assignPendingPositional(positionalIndices[variadicPosition + 1 + i], m_trailingPositionals[i]);
+				}
 			}
 		}
 
-		std::string usage() const override {
-			return OptionBase<T, N>::usage(typeName());
+		// option names are matched ignoring case, '-', ' ' and '_', e.g. "cake-size" and "Cake Size"
+		//   match the environment variable CAKE_SIZE and the config key cake_size
+		static char keyCharacter(char c) {
+			if (c == '-' || c == ' ')
+				return '_';
+			else if (c >= 'a' && c <= 'z')
+				return static_cast<char>(c - 'a' + 'A');
+			return c;
 		}
-		std::string help(size_t descriptionIndentation) const override {
-			return OptionBase<T, N>::help(descriptionIndentation, typeName());
+		static bool keyLess(const std::string_view& a, const std::string_view& b) {
+			return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+				[](char x, char y) { return keyCharacter(x) < keyCharacter(y); });
 		}
-	};
 
-	class HelpSection {
-		const std::string_view m_title;
-	public:
-		HelpSection(const std::string_view& title) :
-			m_title{title} {}
+		template<size_t I = 0>
+		inline void buildOptionNames(std::vector<LongArgument>& names) const {
+			if constexpr(isOption<OptionAt<I>>)
+				names.push_back(LongArgument{std::get<I>(m_options).name(), I, OptionAt<I>::takesValue});
+			if constexpr(I+1 != sizeof...(Options)) {
+				buildOptionNames<I+1>(names);
+			}
+			else {
+				std::sort(names.begin(), names.end(),
+					[](const LongArgument& a, const LongArgument& b) { return keyLess(a.name, b.name); });
+			}
+		}
+		// @return the option named @param key in @param names (built by buildOptionNames()), or nullptr
+		static const LongArgument* findOptionName(const std::vector<LongArgument>& names, const std::string_view& key) {
+			auto found = std::lower_bound(names.begin(), names.end(), key,
+				[](const LongArgument& a, const std::string_view& b) { return keyLess(a.name, b); });
+			if (found == names.end() || keyLess(key, found->name))
+				return nullptr;
+			return &*found;
+		}
 
-		std::string help(size_t) const {
-			return std::string{m_title} + '\n';
+		// assigns @param value to the option at @param index, reading it as a boolean for switches
+		void assignKeyValue(size_t index, bool takesValue, const std::string_view& value, const std::string_view& arg) {
+			if (takesValue)
+				assignValueAt(index, value, arg);
+			else
+				assignSwitchAt(index, value, arg);
 		}
-	};
 
-	template<class... Options>
-	class ArgParser {
-		std::tuple<Options...> m_options;
+		// @return the value of a switch in an environment variable or a config file (e.g. 1, true, yes or on),
+		//   or std::nullopt if it is not a boolean
+		static std::optional<bool> switchFromString(const std::string_view& value) {
+			for (std::string_view truthy : {"", "1", "true", "yes", "on", "TRUE", "YES", "ON", "True", "Yes", "On"})
+				if (value == truthy)
+					return true;
+			for (std::string_view falsy : {"0", "false", "no", "off", "FALSE", "NO", "OFF", "False", "No", "Off"})
+				if (value == falsy)
+					return false;
+			return std::nullopt;
+		}
 
-		const std::string_view m_programName;
-		std::optional<std::string> m_executableName;
-		const size_t m_descriptionIndentation;
+		// assigns @param value, provided by @param variable, to the switch at @param index;
+		//   counts also accept a number, e.g. VERBOSE=3
+		template<size_t I = 0>
+		inline void assignSwitchAt(size_t index, const std::string_view& value, const std::string_view& variable) {
+			if constexpr(isOption<OptionAt<I>>) {
+				if constexpr(!OptionAt<I>::takesValue) {
+					if (index == I) {
+						if constexpr(isCount<OptionAt<I>>) {
+							if (!value.empty() && (isdigit(value.front()) || value.front() == '-' || value.front() == '+')) {
+								auto& option = std::get<I>(m_options);
+								option.assignCount(argumentFromString<typename OptionAt<I>::OutputType>(value, option.name(), variable), variable);
+								m_provenance[I] = Provenance{m_source, m_position};
+								return;
+							}
+						}
 
-		bool m_doneAssigning;
+						std::optional<bool> set = switchFromString(value);
+						if (!set.has_value())
+							throw std::runtime_error("Option " + std::string{std::get<I>(m_options).name()} +
+								" does not accept a value: " + std::string{variable});
+						if constexpr(isNegatable<OptionAt<I>>)
+							std::get<I>(m_options).assignSwitch(*set, variable);
+						else if (*set)
+							std::get<I>(m_options).assignValue({}, variable);
+						else
+							return;
+						m_provenance[I] = Provenance{m_source, m_position};
+						return;
+					}
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				assignSwitchAt<I+1>(index, value, variable);
+		}
 
+		// @return the index of the option named @param name, or sizeof...(Options) if there is none
 		template<size_t I = 0>
-		inline void assign(const std::string_view& arg) {
-			if constexpr(!std::is_same_v<std::tuple_element_t<I, std::tuple<Options...>>, HelpSection>)
-				if (!m_doneAssigning)
-					m_doneAssigning = std::get<I>(m_options).assign(arg);
+		inline size_t optionIndex(const std::string_view& name) const {
+			if constexpr(isOption<OptionAt<I>>)
+				if (std::get<I>(m_options).name() == name)
+					return I;
 			if constexpr(I+1 != sizeof...(Options))
-				assign<I+1>(arg);
+				return optionIndex<I+1>(name);
+			else
+				return sizeof...(Options);
+		}
+
+		template<size_t I = 0>
+		inline bool seenAt(size_t index) const {
+			if constexpr(isOption<OptionAt<I>>)
+				if (index == I)
+					return std::get<I>(m_options).seen();
+			if constexpr(I+1 != sizeof...(Options))
+				return seenAt<I+1>(index);
+			else
+				return false;
+		}
+
+		// runs the subcommand named @param first, if there is one, with the arguments in [first, last)
+		template<class Iter, size_t I = 0>
+		bool runSubcommand(const Iter& first, const Iter& last) {
+			if constexpr(isSubcommand<OptionAt<I>>) {
+				if (std::get<I>(m_options).name() == std::string_view{*first}) {
+					m_subcommand = std::get<I>(m_options).name();
+					std::get<I>(m_options).run(first, last);
+					return true;
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				return runSubcommand<Iter, I+1>(first, last);
+			else
+				return false;
+		}
+
+		template<size_t I = 0>
+		inline std::string subcommandsUsage() const {
+			std::string result;
+			if constexpr(isSubcommand<OptionAt<I>>) {
+				result += '|';
+				result.append(std::get<I>(m_options).name());
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				result.append(subcommandsUsage<I+1>());
+			return result;
+		}
+
+		// arguments like "-x" or "--abc" are never positional, unless they come after "--"
+		static bool isOptionLike(const std::string_view& arg) {
+			return arg.size() > 1 && arg[0] == '-';
+		}
+
+		static void suggestName(const LevenshteinPattern& pattern, size_t patternSize,
+				const std::string_view& name, const std::string_view& suggestion,
+				std::string_view& best, size_t& bestDistance) {
+			// the distance is at least the difference of the lengths
+			if ((name.size() > patternSize ? name.size() - patternSize : patternSize - name.size()) >= bestDistance)
+				return;
+			if (size_t distance = pattern.distance(name); distance < bestDistance) {
+				best = suggestion;
+				bestDistance = distance;
+			}
+		}
+
+		template<size_t I = 0>
+		void suggestArgument(const LevenshteinPattern& pattern, size_t patternSize,
+				std::string_view& best, size_t& bestDistance) const {
+			if constexpr(isOption<OptionAt<I>>) {
+				for (auto&& argument : std::get<I>(m_options).arguments()) {
+					std::string_view name = (!argument.empty() && argument.back() == '=') ? argument.substr(0, argument.size() - 1) : argument;
+					suggestName(pattern, patternSize, name, argument, best, bestDistance);
+				}
+			}
+			else if constexpr(isSubcommand<OptionAt<I>>) {
+				std::string_view name = std::get<I>(m_options).name();
+				suggestName(pattern, patternSize, name, name, best, bestDistance);
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				suggestArgument<I+1>(pattern, patternSize, best, bestDistance);
+		}
+
+		// only called when parsing fails, so that suggestions cost nothing otherwise
+		std::string unknownArgumentMessage(const std::string_view& arg) const {
+			std::string result = "Unknown argument: " + std::string{arg};
+
+			std::string_view name = arg.substr(0, arg.find('='));
+			if (name.empty() || name.size() > LevenshteinPattern::maxSize)
+				return result;
+
+			// allow about one typo every three characters
+			size_t maxDistance = std::min<size_t>(3, name.size() / 3);
+			if (maxDistance == 0)
+				return result;
+			std::string_view best;
+			size_t bestDistance = maxDistance + 1;
+			suggestArgument(LevenshteinPattern{name}, name.size(), best, bestDistance);
+			if (!best.empty())
+				result.append(" (did you mean " + std::string{best} + "?)");
+			return result;
 		}
 
 		template<size_t I = 0>
 		inline void checkValidity() const {
-			if constexpr(!std::is_same_v<std::tuple_element_t<I, std::tuple<Options...>>, HelpSection>)
+			if constexpr(isOption<OptionAt<I>>)
 				std::get<I>(m_options).checkValidity();
 			if constexpr(I+1 != sizeof...(Options))
 				checkValidity<I+1>();
@@ -363,12 +2225,174 @@ namespace stypox {
 
 		template<size_t I = 0>
 		inline void resetOptions() {
-			if constexpr(!std::is_same_v<std::tuple_element_t<I, std::tuple<Options...>>, HelpSection>)
+			if constexpr(isOption<OptionAt<I>>)
 				std::get<I>(m_options).reset();
 			if constexpr(I+1 != sizeof...(Options))
 				resetOptions<I+1>();
 		}
 
+		// resets the option at @param index and assigns it again with the recorded @param raw
+		//   assignments, then checks its validity
+		template<size_t I = 0>
+		inline void reassignAt(size_t index, const std::vector<RawAssignment>& raw) {
+			if constexpr(isOption<OptionAt<I>>) {
+				if (index == I) {
+					auto& option = std::get<I>(m_options);
+					option.reset();
+					for (auto&& assignment : raw) {
+						if (assignment.index != I)
+							continue;
+						if (assignment.wholeArgument)
+							option.assign(assignment.arg);
+						else
+							option.assignValue(assignment.value, assignment.arg);
+					}
+					option.checkValidity();
+					return;
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				reassignAt<I+1>(index, raw);
+		}
+
+		// @return the raw assignments of the option at @param index as a string, to compare them
+		static std::string rawText(size_t index, const std::vector<RawAssignment>& raw) {
+			std::string result;
+			for (auto&& assignment : raw) {
+				if (assignment.index != index)
+					continue;
+				// the values do not depend on how they were provided, e.g. "-n 5" or "-n=5"
+				result.append(assignment.value);
+				result += '\0';
+			}
+			return result;
+		}
+
+		// FNV-1a, continuing from @param hash
+		static uint64_t hashBytes(const std::string_view& data, uint64_t hash = 14695981039346656037ull) {
+			for (char c : data) {
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		static constexpr uint64_t snapshotMagic = 0x31746f6873706e73ull; // "snpshot1"
+		static constexpr uint32_t snapshotVersion = 1;
+
+		// @return a hash of the names, arguments, types and output sizes of the options, so that
+		//   snapshots are not restored by a parser with different options
+		template<size_t I = 0>
+		inline uint64_t specificationHash(uint64_t hash = hashBytes({})) const {
+			if constexpr(isOption<OptionAt<I>>) {
+				auto& option = std::get<I>(m_options);
+				hash = hashBytes(option.name(), hash);
+				for (auto&& argument : option.arguments())
+					hash = hashBytes(argument, hashBytes({"\0", 1}, hash));
+				hash = hashBytes(option.usage(), hashBytes({"\0", 1}, hash));
+				hash = hashBytes(std::to_string(sizeof(typename OptionAt<I>::OutputType)), hashBytes({"\0", 1}, hash));
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				return specificationHash<I+1>(hashBytes({"\n", 1}, hash));
+			else
+				return hash;
+		}
+
+		// @return the sum of the fingerprints of the encountered options, so that it does not depend on their order
+		template<size_t I = 0>
+		inline uint64_t fingerprintOptions() const {
+			uint64_t hash = 0;
+			if constexpr(isOption<OptionAt<I>>) {
+				auto& option = std::get<I>(m_options);
+				if (option.seen())
+					hash = mixFingerprint(option.fingerprint(fingerprintBytes(option.name(), 0)));
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				return hash + fingerprintOptions<I+1>();
+			else
+				return hash;
+		}
+
+		template<size_t I = 0>
+		inline void saveOptions(std::string& snapshot) const {
+			if constexpr(isOption<OptionAt<I>>)
+				if (std::get<I>(m_options).seen())
+					std::get<I>(m_options).save(snapshot);
+			if constexpr(I+1 != sizeof...(Options))
+				saveOptions<I+1>(snapshot);
+		}
+		// @param seen is the bitmap of the options to load
+		template<size_t I = 0>
+		inline bool loadOptions(std::string_view& snapshot, const std::string_view& seen) {
+			if constexpr(isOption<OptionAt<I>>) {
+				if (seen[I / 8] & (1 << (I % 8))) {
+					if (!std::get<I>(m_options).load(snapshot))
+						return false;
+					m_provenance[I] = Provenance{Source::snapshot, 0};
+				}
+			}
+			if constexpr(I+1 != sizeof...(Options))
+				return loadOptions<I+1>(snapshot, seen);
+			else
+				return true;
+		}
+
+		template<size_t I = 0>
+		inline void bindOptions(void* config, const void* configType) {
+			if constexpr(isOption<OptionAt<I>>)
+				std::get<I>(m_options).bind(config, configType);
+			if constexpr(I+1 != sizeof...(Options))
+				bindOptions<I+1>(config, configType);
+		}
+
+		// the state of the parser besides the options, which transactions restore if they fail
+		struct ParserState {
+			std::array<Provenance, sizeof...(Options)> provenance;
+			std::optional<std::string_view> executableName;
+			std::string ownedExecutableName;
+			std::string_view subcommand;
+			size_t positionalArguments;
+			std::array<std::string, sizeof...(Options)> rawTexts;
+			bool parsedIncrementally;
+		};
+		ParserState saveState() const {
+			return ParserState{m_provenance, m_executableName, m_ownedExecutableName,
+				m_subcommand, m_positionalArguments, m_rawTexts, m_parsedIncrementally};
+		}
+		void restoreState(ParserState&& state) {
+			m_provenance = state.provenance;
+			m_ownedExecutableName = std::move(state.ownedExecutableName);
+			// the owned name was moved, so the view has to point to the new string
+			m_executableName = state.executableName.has_value() && !m_ownedExecutableName.empty() ?
+				std::optional<std::string_view>{m_ownedExecutableName} : state.executableName;
+			m_subcommand = state.subcommand;
+			m_positionalArguments = state.positionalArguments;
+			m_rawTexts = std::move(state.rawTexts);
+			m_parsedIncrementally = state.parsedIncrementally;
+		}
+
+		template<size_t I = 0>
+		inline void stageOptions() {
+			if constexpr(isOption<OptionAt<I>>)
+				std::get<I>(m_options).stage();
+			if constexpr(I+1 != sizeof...(Options))
+				stageOptions<I+1>();
+		}
+		template<size_t I = 0>
+		inline void commitOptions() {
+			if constexpr(isOption<OptionAt<I>>)
+				std::get<I>(m_options).commit();
+			if constexpr(I+1 != sizeof...(Options))
+				commitOptions<I+1>();
+		}
+		template<size_t I = 0>
+		inline void rollbackOptions() {
+			if constexpr(isOption<OptionAt<I>>)
+				std::get<I>(m_options).rollback();
+			if constexpr(I+1 != sizeof...(Options))
+				rollbackOptions<I+1>();
+		}
+
 		template<size_t I = 0>
 		inline std::string optionsHelp() const {
 			std::string result = std::get<I>(m_options).help(m_descriptionIndentation);
@@ -379,7 +2403,7 @@ namespace stypox {
 		template<size_t I = 0>
 		inline std::string optionsUsage() const {
 			std::string result;
-			if constexpr(!std::is_same_v<std::tuple_element_t<I, std::tuple<Options...>>, HelpSection>)
+			if constexpr(isOption<OptionAt<I>>)
 				result = std::get<I>(m_options).usage();
 			if constexpr(I+1 != sizeof...(Options))
 				result.append(optionsUsage<I+1>());
@@ -389,9 +2413,16 @@ namespace stypox {
 	public:
 		ArgParser(std::tuple<Options...> options,
 				const std::string_view& programName,
-				size_t descriptionIndentation = 25) :
-			m_options{options}, m_programName{programName},
-			m_executableName{}, m_descriptionIndentation{descriptionIndentation} {}
+				size_t descriptionIndentation = 25,
+				ParserFlags flags = ParserFlags::none) :
+			m_options{std::move(options)}, m_programName{programName},
+			m_executableName{}, m_ownedExecutableName{},
+			m_descriptionIndentation{descriptionIndentation}, m_flags{flags},
+			m_shortOptions{}, m_shortOptionsBuilt{false},
+			m_longArguments{}, m_longArgumentsBuilt{false},
+			m_subcommand{}, m_positionalArguments{0}, m_trailingPositionals{},
+			m_recording{false}, m_rawAssignments{}, m_rawTexts{}, m_parsedIncrementally{false},
+			m_source{Source::none}, m_position{0}, m_provenance{} {}
 
 		template<class Iter>
 		#if __cplusplus > 201703L || defined(__cpp_concepts)
@@ -399,64 +2430,228 @@ namespace stypox {
 				std::is_convertible_v<typename std::iterator_traits<Iter>::value_type, std::string_view>
 		#endif
 		void parse(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
-			if (firstArgumentIsExecutablePath) {
-				if (first == last)
-					throw std::out_of_range("stypox::ArgParser::parse(): too few items");
-				m_executableName = *first;
-				++first;
-			}
-			else {
-				m_executableName = std::nullopt;
-			}
+			checkIterator<Iter>();
+			parseExecutableName(first, last, firstArgumentIsExecutablePath);
+			resetPositionals();
+			m_source = Source::commandLine;
+			m_position = firstArgumentIsExecutablePath ? 1 : 0;
 
-			for(; first != last; ++first) {
-				m_doneAssigning = false;
-				if constexpr(std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string>) {
-					assign(first->c_str());
-					if(!m_doneAssigning)
-						throw std::runtime_error("Unknown argument: " + *first);
-				}
-				else {
-					assign(*first);
-					if(!m_doneAssigning)
-						throw std::runtime_error("Unknown argument: " + std::string{std::string_view{*first}});
-				}
+			bool onlyPositionals = false; // after "--"
+			for(; first != last; ++first, ++m_position) {
+				auto&& argument = *first; // kept alive for the iteration
+				std::string_view arg{argument};
+				if (!onlyPositionals && arg == "--")
+					onlyPositionals = true;
+				else if (hasSubcommands && !onlyPositionals && !isOptionLike(arg) && runSubcommand(first, last))
+					break;
+				else if (!(!onlyPositionals && parseArgument(arg, first, last)) &&
+						!((onlyPositionals || !isOptionLike(arg)) && assignPositional(arg)))
+					throw std::runtime_error(unknownArgumentMessage(arg));
 			}
+			finishPositionals();
 		}
 		void parse(int argc, char const* argv[], bool firstArgumentIsExecutablePath = true) {
 			return parse(argv, argv+argc, firstArgumentIsExecutablePath);
 		}
 
+		// @return a stable hash of the names and canonical values of the encountered options, which does
+		//   not depend on the order of the options nor on where their values come from, e.g. to use the
+		//   effective configuration as a cache key
+		uint64_t fingerprint() const {
+			return mixFingerprint(fingerprintOptions());
+		}
+
+		// @return a hash of the arguments in [first, last), to check that a snapshot was made
+		//   from the same arguments, see saveSnapshot()
+		template<class Iter>
+		static uint64_t argumentsFingerprint(Iter first, const Iter& last) {
+			uint64_t hash = hashBytes({});
+			for (; first != last; ++first)
+				hash = hashBytes({"\0", 1}, hashBytes(std::string_view{*first}, hash));
+			return hash;
+		}
+		static uint64_t argumentsFingerprint(int argc, char const* argv[]) {
+			return argumentsFingerprint(argv, argv+argc);
+		}
+
+		// @return a binary snapshot of the values of the encountered options, to be restored with
+		//   restoreSnapshot() by a parser with the same options, without parsing again
+		// @param argumentsFingerprint identifies the arguments that were parsed, see argumentsFingerprint()
+		std::string saveSnapshot(uint64_t argumentsFingerprint) const {
+			std::string snapshot;
+			Serializer<uint64_t>::save(snapshot, snapshotMagic);
+			Serializer<uint32_t>::save(snapshot, snapshotVersion);
+			Serializer<uint64_t>::save(snapshot, specificationHash());
+			Serializer<uint64_t>::save(snapshot, argumentsFingerprint);
+
+			std::array<unsigned char, (sizeof...(Options) + 7) / 8> seen{};
+			for (size_t i = 0; i < sizeof...(Options); ++i)
+				if (seenAt(i))
+					seen[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+			snapshot.append(reinterpret_cast<const char*>(seen.data()), seen.size());
+
+			saveOptions(snapshot);
+			return snapshot;
+		}
+		// restores the values saved by saveSnapshot(), as if the arguments had been parsed and validated
+		//   again; values that are views (e.g. std::string_view) point into @param snapshot
+		// @return false, leaving everything unchanged, if @param snapshot was made by a parser with
+		//   other options, from other arguments than @param argumentsFingerprint, or is invalid
+		bool restoreSnapshot(std::string_view snapshot, uint64_t argumentsFingerprint) {
+			uint64_t magic, specification, fingerprint;
+			uint32_t version;
+			constexpr size_t seenSize = (sizeof...(Options) + 7) / 8;
+			if (!Serializer<uint64_t>::load(snapshot, magic) || magic != snapshotMagic ||
+					!Serializer<uint32_t>::load(snapshot, version) || version != snapshotVersion ||
+					!Serializer<uint64_t>::load(snapshot, specification) || specification != specificationHash() ||
+					!Serializer<uint64_t>::load(snapshot, fingerprint) || fingerprint != argumentsFingerprint ||
+					snapshot.size() < seenSize)
+				return false;
+			std::string_view seen = snapshot.substr(0, seenSize);
+			snapshot.remove_prefix(seenSize);
+
+			std::array<Provenance, sizeof...(Options)> provenance = m_provenance;
+			stageOptions();
+			bool valid;
+			try {
+				resetOptions();
+				m_provenance.fill(Provenance{Source::none, 0});
+				valid = loadOptions(snapshot, seen) && snapshot.empty();
+			}
+			catch (...) {
+				rollbackOptions();
+				m_provenance = provenance;
+				throw;
+			}
+			if (!valid) {
+				rollbackOptions();
+				m_provenance = provenance;
+				return false;
+			}
+			commitOptions();
+			return true;
+		}
+
+		// makes the options declared with pointers to members of C write into @param config
+		template<class C>
+		void bind(C& config) {
+			bindOptions(&config, &configTypeTag<C>);
+		}
+
+		// calls @param steps (e.g. parsing functions) and validates, writing the outputs only if
+		//   nothing threw; otherwise the exception is propagated and the parser and the outputs
+		//   are left as they were before the call
+		template<class F>
+		void transaction(F&& steps) {
+			stageOptions();
+			ParserState state = saveState();
+			try {
+				steps();
+				validate();
+			}
+			catch (...) {
+				rollbackOptions();
+				restoreState(std::move(state));
+				throw;
+			}
+			commitOptions();
+		}
+
+		// parses again, like parseTransactional(), but converts and validates only the options whose
+		//   arguments changed since the last call; subcommands are run while parsing, so what they
+		//   do is not undone if the new arguments are rejected
+		// @return the names of the options whose arguments changed
 		template<class Iter>
 		#if __cplusplus > 201703L || defined(__cpp_concepts)
 			requires std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string> ||
 				std::is_convertible_v<typename std::iterator_traits<Iter>::value_type, std::string_view>
 		#endif
-		std::vector<std::string> parsePositional(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
-			if (firstArgumentIsExecutablePath) {
-				if (first == last)
-					throw std::out_of_range("stypox::ArgParser::parse(): too few items");
-				m_executableName = *first;
-				++first;
+		std::vector<std::string_view> parseIncremental(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
+			static_assert(std::is_lvalue_reference_v<decltype(*first)>,
+				"stypox::ArgParser::parseIncremental(): the iterator must yield references to strings "
+				"that outlive the parse, since the recorded assignments are views into the arguments");
+			// recording does not write the options, so they can be staged before parsing
+			stageOptions();
+			ParserState state = saveState();
+			std::array<std::string, sizeof...(Options)> rawTexts;
+			std::vector<std::string_view> changed;
+			m_rawAssignments.clear();
+			m_recording = true;
+			try {
+				parse(first, last, firstArgumentIsExecutablePath);
+				m_recording = false;
+
+				for (size_t i = 0; i < sizeof...(Options); ++i) {
+					rawTexts[i] = rawText(i, m_rawAssignments);
+					bool optionChanged = rawTexts[i] != m_rawTexts[i];
+					// the first time every option is validated, since required ones may be missing
+					if (optionChanged || !m_parsedIncrementally)
+						reassignAt(i, m_rawAssignments);
+					if (optionChanged)
+						changed.push_back(optionName(i));
+					if (rawTexts[i].empty())
+						m_provenance[i] = Provenance{Source::none, 0}; // not passed anymore
+				}
 			}
-			else {
-				m_executableName = std::nullopt;
+			catch (...) {
+				m_recording = false;
+				rollbackOptions();
+				restoreState(std::move(state));
+				m_rawAssignments.clear();
+				throw;
 			}
+			commitOptions();
+			m_rawTexts = std::move(rawTexts);
+			m_parsedIncrementally = true;
+			m_rawAssignments.clear(); // they are views into the arguments
+			return changed;
+		}
+		std::vector<std::string_view> parseIncremental(int argc, char const* argv[], bool firstArgumentIsExecutablePath = true) {
+			return parseIncremental(argv, argv+argc, firstArgumentIsExecutablePath);
+		}
+
+		// parses again from scratch, like reset() followed by parse() and validate(), in a transaction
+		template<class Iter>
+		#if __cplusplus > 201703L || defined(__cpp_concepts)
+			requires std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string> ||
+				std::is_convertible_v<typename std::iterator_traits<Iter>::value_type, std::string_view>
+		#endif
+		void parseTransactional(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
+			transaction([&] {
+				reset();
+				parse(first, last, firstArgumentIsExecutablePath);
+			});
+		}
+		void parseTransactional(int argc, char const* argv[], bool firstArgumentIsExecutablePath = true) {
+			return parseTransactional(argv, argv+argc, firstArgumentIsExecutablePath);
+		}
+
+		template<class Iter>
+		#if __cplusplus > 201703L || defined(__cpp_concepts)
+			requires std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string> ||
+				std::is_convertible_v<typename std::iterator_traits<Iter>::value_type, std::string_view>
+		#endif
+		std::vector<std::string> parsePositional(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
+			checkIterator<Iter>();
+			parseExecutableName(first, last, firstArgumentIsExecutablePath);
+			resetPositionals();
+			m_source = Source::commandLine;
+			m_position = firstArgumentIsExecutablePath ? 1 : 0;
 
 			std::vector<std::string> positionalArguments;
-			for(; first != last; ++first) {
-				m_doneAssigning = false;
-				if constexpr(std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string>) {
-					assign(first->c_str());
-					if(!m_doneAssigning)
-						positionalArguments.push_back(first);
-				}
-				else {
-					assign(*first);
-					if(!m_doneAssigning)
-						positionalArguments.push_back(std::string{std::string_view{*first}});
-				}
+			bool onlyPositionals = false; // after "--"
+			for(; first != last; ++first, ++m_position) {
+				auto&& argument = *first; // kept alive for the iteration
+				std::string_view arg{argument};
+				if (!onlyPositionals && arg == "--")
+					onlyPositionals = true;
+				else if (hasSubcommands && !onlyPositionals && !isOptionLike(arg) && runSubcommand(first, last))
+					break;
+				else if (!(!onlyPositionals && parseArgument(arg, first, last)) &&
+						!((onlyPositionals || !isOptionLike(arg)) && assignPositional(arg)))
+					positionalArguments.push_back(std::string{arg});
 			}
+			finishPositionals();
 
 			return positionalArguments;
 		}
@@ -464,24 +2659,158 @@ namespace stypox {
 			return parsePositional(argv, argv+argc, firstArgumentIsExecutablePath);
 		}
 
+		template<class Iter>
+		#if __cplusplus > 201703L || defined(__cpp_concepts)
+			requires std::is_same_v<typename std::iterator_traits<Iter>::value_type, std::string> ||
+				std::is_convertible_v<typename std::iterator_traits<Iter>::value_type, std::string_view>
+		#endif
+		Iter parseUntilPositional(Iter first, const Iter& last, bool firstArgumentIsExecutablePath) {
+			checkIterator<Iter>();
+			parseExecutableName(first, last, firstArgumentIsExecutablePath);
+			resetPositionals();
+			m_source = Source::commandLine;
+			m_position = firstArgumentIsExecutablePath ? 1 : 0;
+
+			for(; first != last; ++first, ++m_position) {
+				auto&& argument = *first; // kept alive for the iteration
+				std::string_view arg{argument};
+				if (arg == "--")
+					return ++first;
+				else if (parseArgument(arg, first, last))
+					continue;
+				else if (isOptionLike(arg))
+					throw std::runtime_error(unknownArgumentMessage(arg));
+				else if (hasSubcommands && runSubcommand(first, last))
+					return last;
+				else if (m_positionalArguments == fixedPositionalCount || !assignPositional(arg))
+					break;
+				else if (m_positionalArguments == fixedPositionalCount)
+					return ++first; // the rest belongs to the last positional argument
+			}
+			return first;
+		}
+		char const** parseUntilPositional(int argc, char const* argv[], bool firstArgumentIsExecutablePath = true) {
+			return parseUntilPositional(argv, argv+argc, firstArgumentIsExecutablePath);
+		}
+
+		// assigns the options not encountered yet from the environment variables named
+		//   @param prefix followed by the option name, e.g. APP_CAKE for "cake" with the prefix "APP_"
+		// @param environment is the null-terminated array of "NAME=value" strings, e.g. environ
+		void parseEnvironment(const std::string_view& prefix, char const* const* environment) {
+			std::vector<LongArgument> names;
+			buildOptionNames(names);
+
+			// a single pass over the environment, with a binary search for every variable with the prefix
+			m_source = Source::environment;
+			m_position = 0;
+			for (; *environment != nullptr; ++environment, ++m_position) {
+				std::string_view variable{*environment};
+				if (variable.substr(0, prefix.size()) != prefix)
+					continue;
+				size_t equals = variable.find('=', prefix.size());
+				if (equals == std::string_view::npos)
+					continue;
+				std::string_view name = variable.substr(prefix.size(), equals - prefix.size());
+
+				const LongArgument* found = findOptionName(names, name);
+				if (found == nullptr || seenAt(found->index))
+					continue; // the command line has precedence over the environment
+
+				// errors show the whole variable, e.g. "APP_CAKE=x"
+				assignKeyValue(found->index, found->takesValue, variable.substr(equals + 1), variable);
+			}
+		}
+
+		// assigns the options not encountered yet from the "key = value" lines of @param config
+		//   (an INI or TOML file), where keys are option names; "[section]" lines are ignored,
+		//   comments start with '#' or ';' and values can be quoted
+		// values that are views (e.g. std::string_view) point into @param config
+		void parseConfig(const std::string_view& config) {
+			std::vector<LongArgument> names;
+			buildOptionNames(names);
+			// options encountered before, e.g. on the command line, which has precedence over the file;
+			//   this way repeatable options can be repeated in the file
+			std::array<bool, sizeof...(Options)> seenBefore{};
+			for (auto&& name : names)
+				seenBefore[name.index] = seenAt(name.index);
+
+			constexpr std::string_view whitespace = " \t\r";
+			size_t lineNumber = 0;
+			m_source = Source::configFile;
+			for (size_t begin = 0; begin < config.size(); ) {
+				size_t end = config.find('\n', begin);
+				if (end == std::string_view::npos)
+					end = config.size();
+				std::string_view line = config.substr(begin, end - begin);
+				begin = end + 1;
+				++lineNumber;
+				m_position = static_cast<uint32_t>(lineNumber);
+
+				line.remove_prefix(std::min(line.find_first_not_of(whitespace), line.size()));
+				line.remove_suffix(line.size() - std::min(line.find_last_not_of(whitespace) + 1, line.size()));
+				if (line.empty() || line[0] == '#' || line[0] == ';' || line[0] == '[')
+					continue;
+
+				size_t equals = line.find('=');
+				std::string_view key = line.substr(0, equals), value;
+				key.remove_suffix(key.size() - std::min(key.find_last_not_of(whitespace) + 1, key.size()));
+				if (equals != std::string_view::npos) {
+					value = line.substr(equals + 1);
+					value.remove_prefix(std::min(value.find_first_not_of(whitespace), value.size()));
+					if (value.size() >= 2 && (value[0] == '"' || value[0] == '\'')) {
+						if (size_t quote = value.find(value[0], 1); quote != std::string_view::npos)
+							value = value.substr(1, quote - 1);
+					}
+					else if (size_t comment = value.find(" #"); comment != std::string_view::npos) {
+						value = value.substr(0, comment);
+						value.remove_suffix(value.size() - std::min(value.find_last_not_of(whitespace) + 1, value.size()));
+					}
+				}
+
+				const LongArgument* found = findOptionName(names, key);
+				if (found == nullptr)
+					throw std::runtime_error("Unknown option at line " + std::to_string(lineNumber) + ": " + std::string{line});
+				if (!seenBefore[found->index])
+					assignKeyValue(found->index, found->takesValue, value, line);
+			}
+		}
+		// @return where the current value of the option named @param name comes from
+		Provenance provenance(const std::string_view& name) const {
+			size_t index = optionIndex(name);
+			if (index == sizeof...(Options))
+				throw std::out_of_range("stypox::ArgParser::provenance(): unknown option: " + std::string{name});
+			return m_provenance[index];
+		}
+
+		// @return the name of the subcommand that was run by the last parse, or an empty string
+		std::string_view subcommand() const {
+			return m_subcommand;
+		}
+
 		void validate() const {
 			checkValidity();
 		}
 
 		void reset() {
 			m_executableName = std::nullopt;
+			m_ownedExecutableName.clear();
 			resetOptions();
+			m_provenance.fill(Provenance{Source::none, 0});
+			m_rawTexts.fill({});
+			m_parsedIncrementally = false;
 		}
 
 		std::string usage() const {
 			std::string result{m_programName};
 			result.append("\nLegend: I=integer; D=decimal; T=text; S=custom string; *=required;\nUsage:");
-			if (m_executableName.has_value()) {
+			if (auto name = executableName(); name.has_value()) {
 				result += ' ';
-				result.append(*m_executableName);
+				result.append(*name);
 			}
 
 			result.append(optionsUsage());
+			if constexpr(hasSubcommands)
+				result.append(" {" + subcommandsUsage().substr(1) + "} ...");
 			result += '\n';
 			return result;
 		}
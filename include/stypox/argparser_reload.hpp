@@ -0,0 +1,220 @@
+#ifndef _STYPOX_ARGPARSER_RELOAD_HPP_
+#define _STYPOX_ARGPARSER_RELOAD_HPP_
+
+// config files and run time reloading, kept apart from argparser.hpp since they need
+//   platform headers (e.g. <sys/mman.h>) that define many names and macros
+
+#include "argparser.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#if __has_include(<sys/mman.h>)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#else
+	#include <fstream>
+	#include <iterator>
+#endif
+#if defined(__linux__) && __has_include(<sys/inotify.h>)
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+
+namespace stypox {
+	// a read-only file, memory mapped where possible
+	class MappedFile {
+		const char* m_data;
+		size_t m_size;
+	#if __has_include(<sys/mman.h>)
+		bool m_mapped;
+	#else
+		std::string m_content;
+	#endif
+	public:
+		MappedFile(const std::string& path) :
+			m_data{nullptr}, m_size{0} {
+		#if __has_include(<sys/mman.h>)
+			m_mapped = false;
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd == -1)
+				throw std::runtime_error("Unable to open file: " + path);
+			struct stat status;
+			if (::fstat(fd, &status) == -1) {
+				::close(fd);
+				throw std::runtime_error("Unable to read file: " + path);
+			}
+			m_size = static_cast<size_t>(status.st_size);
+			if (m_size != 0) {
+				void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data == MAP_FAILED) {
+					::close(fd);
+					throw std::runtime_error("Unable to map file: " + path);
+				}
+				m_data = static_cast<const char*>(data);
+				m_mapped = true;
+			}
+			::close(fd);
+		#else
+			std::ifstream file{path, std::ios::binary};
+			if (!file)
+				throw std::runtime_error("Unable to open file: " + path);
+			m_content.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+			m_data = m_content.data();
+			m_size = m_content.size();
+		#endif
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept :
+			m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+		#if __has_include(<sys/mman.h>)
+			m_mapped{std::exchange(other.m_mapped, false)} {}
+		#else
+			m_content{std::move(other.m_content)} {
+			m_data = m_content.data();
+		}
+		#endif
+		MappedFile& operator=(MappedFile&&) = delete;
+		~MappedFile() {
+		#if __has_include(<sys/mman.h>)
+			if (m_mapped)
+				::munmap(const_cast<char*>(m_data), m_size);
+		#endif
+		}
+
+		std::string_view content() const {
+			return {m_data, m_size};
+		}
+	};
+
+	// parses the config file at @param path with @param parser, see ArgParser::parseConfig()
+	// @return the file, that must outlive the values that are views into it
+	template<class... Options>
+	MappedFile parseConfigFile(ArgParser<Options...>& parser, const std::string& path) {
+		MappedFile file{path};
+		parser.parseConfig(file.content());
+		return file;
+	}
+
+	// a configuration shared between threads: readers get the current snapshot without locking,
+	//   and a reload publishes a new snapshot only if it was built successfully
+	template<class T>
+	class Snapshot {
+	#if defined(__cpp_lib_atomic_shared_ptr)
+		std::atomic<std::shared_ptr<const T>> m_current;
+	#else
+		std::shared_ptr<const T> m_current; // only accessed with std::atomic_load/store
+	#endif
+	public:
+		Snapshot(T initial = T{}) :
+			m_current{std::make_shared<const T>(std::move(initial))} {}
+		Snapshot(const Snapshot&) = delete;
+		Snapshot& operator=(const Snapshot&) = delete;
+
+		// @return the current snapshot, which stays valid (and unchanged) while it is held
+		std::shared_ptr<const T> get() const {
+		#if defined(__cpp_lib_atomic_shared_ptr)
+			return m_current.load(std::memory_order_acquire);
+		#else
+			return std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+		#endif
+		}
+
+		void publish(std::shared_ptr<const T> snapshot) {
+		#if defined(__cpp_lib_atomic_shared_ptr)
+			m_current.store(std::move(snapshot), std::memory_order_release);
+		#else
+			std::atomic_store_explicit(&m_current, std::move(snapshot), std::memory_order_release);
+		#endif
+		}
+
+		// builds a new snapshot by calling @param fill with a default constructed T, e.g. to
+		//   construct an ArgParser writing into it, parse and validate; if @param fill throws
+		//   the exception is propagated and the current snapshot is kept
+		template<class F>
+		void reload(F&& fill) {
+			auto snapshot = std::make_shared<T>();
+			fill(*snapshot);
+			publish(std::move(snapshot));
+		}
+	};
+
+#if defined(__linux__) && __has_include(<sys/inotify.h>)
+	// watches a file for changes using inotify; the directory is watched, so that files
+	//   replaced by editors (writing a new file and renaming it) are detected too
+	class FileWatcher {
+		int m_descriptor;
+		std::string m_fileName;
+	public:
+		FileWatcher(const std::string& path) :
+			m_descriptor{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)} {
+			if (m_descriptor == -1)
+				throw std::runtime_error("Unable to watch file: " + path);
+
+			size_t separator = path.rfind('/');
+			std::string directory = separator == std::string::npos ? "." : path.substr(0, std::max<size_t>(separator, 1));
+			m_fileName = separator == std::string::npos ? path : path.substr(separator + 1);
+			if (::inotify_add_watch(m_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) == -1) {
+				::close(m_descriptor);
+				throw std::runtime_error("Unable to watch file: " + path);
+			}
+		}
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		~FileWatcher() {
+			::close(m_descriptor);
+		}
+
+		// @return true if the file changed since the last call, without blocking
+		bool changed() {
+			alignas(inotify_event) char buffer[4096];
+			bool result = false;
+			while (true) {
+				ssize_t size = ::read(m_descriptor, buffer, sizeof(buffer));
+				if (size <= 0)
+					return result;
+				for (ssize_t offset = 0; offset < size; ) {
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+					if (event->len != 0 && m_fileName == event->name)
+						result = true;
+					offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+				}
+			}
+		}
+		// waits at most @param timeoutMilliseconds (forever if negative) for the file to change
+		// @return true if the file changed
+		bool wait(int timeoutMilliseconds = -1) {
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{timeoutMilliseconds};
+			pollfd descriptor{m_descriptor, POLLIN, 0};
+			while (true) {
+				int timeout = timeoutMilliseconds;
+				if (timeoutMilliseconds >= 0) {
+					// other files in the directory may have changed, so keep waiting until the deadline
+					auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+					timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+				}
+				if (::poll(&descriptor, 1, timeout) <= 0)
+					return false;
+				if (changed())
+					return true;
+			}
+		}
+
+		// @return the inotify descriptor, e.g. to be used with epoll
+		int descriptor() const {
+			return m_descriptor;
+		}
+	};
+#endif
+}
+
+#endif